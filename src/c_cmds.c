@@ -82,6 +82,7 @@
 
 extern dboolean am_grid;
 extern dboolean am_rotatemode;
+extern dboolean buildreject;
 extern char     *configfile;
 extern int      episode;
 extern int      expansion;
@@ -169,6 +170,7 @@ extern int      r_blood;
 extern int      r_bloodsplats_max;
 extern int      r_bloodsplats_total;
 extern dboolean r_brightmaps;
+extern dboolean r_columnmajor;
 extern dboolean r_corpses_mirrored;
 extern dboolean r_corpses_moreblood;
 extern dboolean r_corpses_nudge;
@@ -190,9 +192,11 @@ extern dboolean r_playersprites;
 extern dboolean r_rockettrails;
 extern int      r_screensize;
 extern dboolean r_shadows;
+extern int      r_threads;
 extern dboolean r_translucency;
 extern int      runcount;
 extern char     *savegamefolder;
+extern int      sightthreads;
 extern int      s_musicvolume;
 extern dboolean s_randompitch;
 extern int      s_sfxvolume;
@@ -212,6 +216,7 @@ extern dboolean vid_vsync;
 extern dboolean vid_widescreen;
 extern char     *vid_windowposition;
 extern char     *vid_windowsize;
+extern int      zipcachesize;
 
 extern int      pixelwidth;
 extern int      pixelheight;
@@ -371,9 +376,12 @@ static void C_ScaleFilter(char *, char *, char *);
 static void C_ScreenSize(char *, char *, char *);
 static void C_ScreenResolution(char *, char *, char *);
 static void C_ShowFPS(char *, char *, char *);
+static void C_SightStats(char *, char *, char *);
 static void C_Spawn(char *, char *, char *);
 static void C_Str(char *, char *, char *);
 static void C_ThingList(char *, char *, char *);
+static void C_ThinkerProfile(char *, char *, char *);
+static void C_ThinkerStats(char *, char *, char *);
 static void C_Time(char *, char *, char *);
 static void C_UnBind(char *, char *, char *);
 static void C_Volume(char *, char *, char *);
@@ -436,6 +444,7 @@ consolecmd_t consolecmds[] =
     CVAR_BOOL (am_grid, C_BoolCondition, C_Bool, "Toggles the grid in the automap."),
     CVAR_BOOL (am_rotatemode, C_BoolCondition, C_Bool, "Toggles rotate mode in the automap."),
     CMD       (bind, C_NoCondition, C_Bind, 2, "[~control~ [+~action~]]", "Binds an action to a control."),
+    CVAR_BOOL (buildreject, C_BoolCondition, C_Bool, "Toggles building a REJECT table for maps that don't have one."),
     CMD       (clear, C_NoCondition, C_Clear, 0, "", "Clears the console."),
     CMD       (cmdlist, C_NoCondition, C_CmdList, 1, "[~searchstring~]", "Shows a list of console commands."),
     CMD       (condump, C_NoCondition, C_ConDump, 1, "[~filename~.txt]", "Dumps the console to a file."),
@@ -474,6 +483,7 @@ consolecmd_t consolecmds[] =
     CVAR_STR  (iwadfolder, C_NoCondition, C_Str, "The folder where an IWAD file was last opened."),
     CMD       (kill, C_KillCondition, C_Kill, 1, "[all|~type~]", "Kills the player, all monsters or a type of monster."),
     CMD       (load, C_LoadCondition, C_Load, 1, "~filename~.save", "Loads a game from a file."),
+    CVAR_INT  (lumplookups, C_IntCondition, C_Int, CF_READONLY, NOALIAS, "The number of lumps looked up by name since the game started."),
     CVAR_FLOAT(m_acceleration, C_FloatCondition, C_Float, CF_NONE, "The amount the mouse accelerates."),
     CVAR_BOOL (m_doubleclick_use, C_BoolCondition, C_Bool, "Toggles double-clicking a mouse button for the +use action."),
     CVAR_BOOL (m_novertical, C_BoolCondition, C_Bool, "Toggles no vertical movement of the mouse."),
@@ -495,6 +505,7 @@ consolecmd_t consolecmds[] =
     CVAR_INT  (r_bloodsplats_max, C_MaxBloodSplatsCondition, C_MaxBloodSplats, CF_NONE, SPLATALIAS, "The maximum number of blood splats allowed in a map."),
     CVAR_INT  (r_bloodsplats_total, C_IntCondition, C_Int, CF_READONLY, NOALIAS, "The total number of blood splats in the current map."),
     CVAR_BOOL (r_brightmaps, C_BoolCondition, C_Bool, "Toggles brightmaps on certain wall textures."),
+    CVAR_BOOL (r_columnmajor, C_BoolCondition, C_Bool, "Toggles drawing the view column by column into a separate buffer."),
     CVAR_BOOL (r_corpses_mirrored, C_BoolCondition, C_Bool, "Toggles corpses being randomly mirrored."),
     CVAR_BOOL (r_corpses_moreblood, C_BoolCondition, C_Bool, "Toggles blood splats around corpses when a map is loaded."),
     CVAR_BOOL (r_corpses_nudge, C_BoolCondition, C_Bool, "Toggles corpses being nudged when monsters walk over them."),
@@ -516,6 +527,7 @@ consolecmd_t consolecmds[] =
     CVAR_BOOL (r_rockettrails, C_BoolCondition, C_Bool, "Toggles rocket trails behind player and Cyberdemon rockets."),
     CVAR_INT  (r_screensize, C_IntCondition, C_ScreenSize, CF_NONE, NOALIAS, "The screen size."),
     CVAR_BOOL (r_shadows, C_BoolCondition, C_Bool, "Toggles sprites casting shadows."),
+    CVAR_INT  (r_threads, C_IntCondition, C_Int, CF_NONE, NOALIAS, "The number of threads used to render the view."),
     CVAR_BOOL (r_translucency, C_BoolCondition, C_Bool, "Toggles translucency in sprites and textures."),
     CMD       (resurrect, C_ResurrectCondition, C_Resurrect, 0, "", "Resurrects the player."),
     CVAR_INT  (runcount, C_NoCondition, C_Int, CF_READONLY, NOALIAS, "The number of times "PACKAGE_NAME" has been run."),
@@ -525,10 +537,14 @@ consolecmd_t consolecmds[] =
     CVAR_STR  (s_timiditycfgpath, C_NoCondition, C_Str, "The path of Timidity's configuration file."),
     CMD       (save, C_SaveCondition, C_Save, 1, "~filename~.save", "Saves the game to a file."),
     CVAR_STR  (savegamefolder, C_NoCondition, C_Str, "The folder where savegames are saved."),
+    CMD       (sightstats, C_GameCondition, C_SightStats, 0, "", "Shows how many sight checks in the current map used a batched or cached result."),
+    CVAR_INT  (sightthreads, C_IntCondition, C_Int, CF_NONE, NOALIAS, "The number of threads used to check the sight of monsters."),
     CVAR_INT  (skilllevel, C_IntCondition, C_Int, CF_NONE, NOALIAS, "The currently selected skill level in the menu."),
     CMD       (spawn, C_SpawnCondition, C_Spawn, 1, SPAWNCMDFORMAT, "Spawns a monster or item."),
     CMD       (summon, C_SpawnCondition, C_Spawn, 1, "", ""),
     CMD       (thinglist, C_GameCondition, C_ThingList, 0, "", "Shows a list of things in the current map."),
+    CMD       (thinkerprofile, C_NoCondition, C_ThinkerProfile, 1, "[on|off|~filename~.csv]", "Profiles the time spent by each type of thinker and thing."),
+    CMD       (thinkerstats, C_GameCondition, C_ThinkerStats, 0, "", "Shows stats on the pools that things and thinkers are allocated from."),
     CMD       (unbind, C_NoCondition, C_UnBind, 1, "~control~", "Unbinds an action from a control."),
     CVAR_BOOL (vid_capfps, C_BoolCondition, C_Bool, "Toggles capping of the framerate at 35 FPS."),
     CVAR_INT  (vid_display, C_IntCondition, C_Display, CF_NONE, NOALIAS, "The display used to render the game."),
@@ -545,6 +561,7 @@ consolecmd_t consolecmds[] =
     CVAR_POS  (vid_windowposition, C_NoCondition, C_WindowPosition, "The position of the window on the desktop."),
     CVAR_SIZE (vid_windowsize, C_NoCondition, C_WindowSize, "The size of the window on the desktop."),
     CMD       (warp, C_MapCondition, C_Map, 1, "", ""),
+    CVAR_INT  (zipcachesize, C_IntCondition, C_Int, CF_NONE, NOALIAS, "The amount of memory, in megabytes, used to keep lumps decompressed from zip files."),
 
     { "", C_NoCondition, NULL, 0, 0, CF_NONE, NULL, 0, 0, 0, 0, "", "" }
 };
@@ -2097,6 +2114,24 @@ static void C_ShowFPS(char *cmd, char *parm1, char *parm2)
         C_Output(C_LookupAliasFromValue(vid_showfps, BOOLALIAS));
 }
 
+static void C_SightStats(char *cmd, char *parm1, char *parm2)
+{
+    int tabs[8] = { 120, 210, 0, 0, 0, 0, 0, 0 };
+    int walked = sightchecks - sightbatchhits - sightcachehits;
+
+    if (!sightchecks)
+    {
+        C_Output("No sight checks have been made in this map yet.");
+        return;
+    }
+
+    C_TabbedOutput(tabs, "Result	Checks	Share");
+    C_TabbedOutput(tabs, "Batched	%s	%.1f%%", commify(sightbatchhits), sightbatchhits * 100.0f / sightchecks);
+    C_TabbedOutput(tabs, "Cached	%s	%.1f%%", commify(sightcachehits), sightcachehits * 100.0f / sightchecks);
+    C_TabbedOutput(tabs, "Checked	%s	%.1f%%", commify(walked), walked * 100.0f / sightchecks);
+    C_TabbedOutput(tabs, "Total	%s	100.0%%", commify(sightchecks));
+}
+
 static int      spawntype = NUMMOBJTYPES;
 
 static dboolean C_SpawnCondition(char *cmd, char *parm1, char *parm2)
@@ -2209,6 +2244,129 @@ static void C_ThingList(char *cmd, char *parm1, char *parm2)
     }
 }
 
+static int C_CompareThinkerProfiles(const void *a, const void *b)
+{
+    uint64_t    time1 = (*(thinkerprofile_t **)a)->time;
+    uint64_t    time2 = (*(thinkerprofile_t **)b)->time;
+
+    return (time1 < time2 ? 1 : (time1 > time2 ? -1 : 0));
+}
+
+// Sort the profiles that have been called by the time spent in them.
+static int C_SortThinkerProfiles(thinkerprofile_t *profiles, int count, thinkerprofile_t **sorted)
+{
+    int numsorted = 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (profiles[i].calls)
+            sorted[numsorted++] = &profiles[i];
+
+    qsort(sorted, numsorted, sizeof(*sorted), C_CompareThinkerProfiles);
+    return numsorted;
+}
+
+static void C_DumpThinkerProfile(char *filename)
+{
+    FILE                *file = fopen(filename, "wt");
+    double              frequency = (double)SDL_GetPerformanceFrequency();
+    thinkerprofile_t    *sorted[NUMMOBJTYPES];
+    int                 count;
+    int                 i;
+
+    if (!file)
+    {
+        C_Warning("%s couldn't be written.", uppercase(filename));
+        return;
+    }
+
+    fprintf(file, "kind,name,calls,microseconds,calls per tic,microseconds per tic\n");
+
+    count = C_SortThinkerProfiles(thinkerprofiles, numthinkerprofiles, sorted);
+    for (i = 0; i < count; i++)
+        fprintf(file, "function,%s,%i,%.1f,%.1f,%.2f\n", sorted[i]->name, sorted[i]->calls,
+            sorted[i]->time * 1000000.0 / frequency, (double)sorted[i]->calls / profiledtics,
+            sorted[i]->time * 1000000.0 / frequency / profiledtics);
+
+    count = C_SortThinkerProfiles(thingprofiles, NUMMOBJTYPES, sorted);
+    for (i = 0; i < count; i++)
+        fprintf(file, "thing,%s,%i,%.1f,%.1f,%.2f\n", sorted[i]->name, sorted[i]->calls,
+            sorted[i]->time * 1000000.0 / frequency, (double)sorted[i]->calls / profiledtics,
+            sorted[i]->time * 1000000.0 / frequency / profiledtics);
+
+    fclose(file);
+
+    C_Output("Dumped the thinker profile to the file %s.", uppercase(filename));
+}
+
+static void C_ThinkerProfile(char *cmd, char *parm1, char *parm2)
+{
+    int                 tabs[8] = { 160, 235, 310, 0, 0, 0, 0, 0 };
+    double              frequency = (double)SDL_GetPerformanceFrequency();
+    thinkerprofile_t    *sorted[NUMMOBJTYPES];
+    int                 count;
+    int                 i;
+
+    if (!strcasecmp(parm1, "on"))
+    {
+        P_StartThinkerProfile();
+        C_Output("Profiling the thinkers.");
+        return;
+    }
+    else if (!strcasecmp(parm1, "off"))
+    {
+        P_StopThinkerProfile();
+        C_Output("Stopped profiling the thinkers after %s tics.", commify(profiledtics));
+        return;
+    }
+
+    if (!profiledtics)
+    {
+        C_Output("The thinkers haven't been profiled. Enter \"thinkerprofile on\" to start.");
+        return;
+    }
+
+    if (parm1[0])
+    {
+        C_DumpThinkerProfile(parm1);
+        return;
+    }
+
+    C_Output("The thinkers took %.2fms per tic on average, and %.2fms in the slowest of %s tics.",
+        profiledtime * 1000.0 / frequency / profiledtics, slowestprofiledtic * 1000.0 / frequency,
+        commify(profiledtics));
+
+    C_TabbedOutput(tabs, "Function\tCalls/tic\tTime/tic\tShare");
+
+    count = C_SortThinkerProfiles(thinkerprofiles, numthinkerprofiles, sorted);
+    for (i = 0; i < count; i++)
+        C_TabbedOutput(tabs, "%s\t%.1f\t%.3fms\t%.1f%%", sorted[i]->name,
+            (double)sorted[i]->calls / profiledtics,
+            sorted[i]->time * 1000.0 / frequency / profiledtics,
+            sorted[i]->time * 100.0 / profiledtime);
+
+    C_TabbedOutput(tabs, "Thing\tCalls/tic\tTime/tic\tShare");
+
+    count = C_SortThinkerProfiles(thingprofiles, NUMMOBJTYPES, sorted);
+    for (i = 0; i < MIN(count, 10); i++)
+        C_TabbedOutput(tabs, "%s\t%.1f\t%.3fms\t%.1f%%", sorted[i]->name,
+            (double)sorted[i]->calls / profiledtics,
+            sorted[i]->time * 1000.0 / frequency / profiledtics,
+            sorted[i]->time * 100.0 / profiledtime);
+}
+
+static void C_ThinkerStats(char *cmd, char *parm1, char *parm2)
+{
+    int tabs[8] = { 120, 180, 240, 0, 0, 0, 0, 0 };
+    int i;
+
+    C_TabbedOutput(tabs, "Type\tLive\tPeak\tPooled");
+
+    for (i = 0; i < NUMTHINKERPOOLS; i++)
+        C_TabbedOutput(tabs, "%s\t%s\t%s\t%s", thinkerpools[i].name, commify(thinkerpools[i].live),
+            commify(thinkerpools[i].peak), commify(thinkerpools[i].pooled));
+}
+
 static void C_Time(char *cmd, char *parm1, char *parm2)
 {
     int i = 0;
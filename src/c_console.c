@@ -53,6 +53,7 @@
 #include "i_swap.h"
 #include "i_system.h"
 #include "i_timer.h"
+#include "i_tinttab.h"
 #include "i_video.h"
 #include "m_cheat.h"
 #include "m_menu.h"
@@ -143,7 +144,6 @@ extern dboolean pm_alwaysrun;
 extern int      key_alwaysrun;
 
 void G_ToggleAlwaysRun(void);
-int FindNearestColor(byte *palette, int red, int green, int blue);
 
 static const char *shiftxform =
 {
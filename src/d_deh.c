@@ -1727,11 +1727,15 @@ dboolean CheckPackageWADVersion(void)
                     continue;   // Blank line or comment line
 
                 if (!strcasecmp(inbuffer, PACKAGE_NAMEANDVERSIONSTRING))
+                {
+                    W_ReleaseLumpNum(i);
                     return true;
+                }
             }
+
+            W_ReleaseLumpNum(i);
         }
 
-    Z_ChangeTag(infile.lump, PU_CACHE);
     return false;
 }
 
@@ -1858,7 +1862,7 @@ void ProcessDehFile(char *filename, int lumpnum)
     }
 
     if (infile.lump)
-        Z_ChangeTag(infile.lump, PU_CACHE);     // Mark purgable
+        W_ReleaseLumpNum(lumpnum);              // Mark purgable
     else
         fclose(infile.f);                       // Close real file
 
@@ -76,7 +76,8 @@ typedef enum
     ga_victory,
     ga_worlddone,
     ga_screenshot,
-    ga_reloadgame
+    ga_reloadgame,
+    ga_playdemo
 } gameaction_t;
 
 //
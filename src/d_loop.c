@@ -175,6 +175,29 @@ void TryRunTics(void)
     int         availabletics;
     int         counts;
 
+    // When benchmarking, build and run exactly one tic without reading
+    // input or waiting for real time to pass.
+    if (benchmark)
+    {
+        ticcmd_t        cmd;
+
+        D_ProcessEvents();
+        M_Ticker();
+
+        memset(&cmd, 0, sizeof(ticcmd_t));
+        G_BuildTiccmd(&cmd);
+        netcmds[maketic % BACKUPTICS] = cmd;
+        ++maketic;
+
+        if (advancetitle)
+            D_DoAdvanceTitle();
+
+        G_Ticker();
+        gametic++;
+        gametime++;
+        return;
+    }
+
     // get real tics
     entertic = I_GetTime() / ticdup;
     realtics = entertic - oldentertics;
@@ -65,6 +65,7 @@
 #include "i_swap.h"
 #include "i_system.h"
 #include "i_timer.h"
+#include "i_tinttab.h"
 #include "i_video.h"
 #include "m_argv.h"
 #include "m_config.h"
@@ -105,6 +106,8 @@ char                    *iwadfolder = iwadfolder_default;
 dboolean                devparm;        // started game with -devparm
 dboolean                nomonsters;     // checkparm of -nomonsters
 dboolean                fastparm;       // checkparm of -fast
+dboolean                benchmark;      // checkparm of -benchmark
+static dboolean         drawbench;      // checkparm of -drawbench
 
 int                     runcount = 0;
 
@@ -120,11 +123,45 @@ dboolean                forcewipe = false;
 
 dboolean                splashscreen;
 
+// lumps used while drawing
+static lumpref_t        playpalref = LUMPREF("PLAYPAL");
+static lumpref_t        pauseref = LUMPREF("M_PAUSE");
+
 extern int              expansion;
 extern dboolean         pm_alwaysrun;
 
 int                     startuptimer;
 
+static dboolean         starttimes;     // checkparm of -starttimes
+static char             *starttrace;    // file given with -starttrace
+
+#define MAXSTARTTASKS   64
+
+// A stage of startup, timed for -starttimes. Stages that don't touch the zone
+// memory, the WADs or the console can be run on their own thread. Stages run
+// on the main thread may be nested, and also record how much the process's zone
+// memory grew, and how many page faults it had, while they ran. Both are counted
+// for the whole process, so include whatever worker threads did at the same time.
+typedef struct
+{
+    char                name[64];
+    void                (*func)(void);
+    SDL_Thread          *thread;
+    dboolean            threaded;
+    int                 depth;
+    uint64_t            start;
+    uint64_t            end;
+    uint64_t            zonebytes;
+    int                 pagefaults;
+} starttask_t;
+
+static starttask_t      starttasks[MAXSTARTTASKS];
+static int              numstarttasks;
+
+// the stages begun on the main thread that haven't ended yet
+static int              starttaskstack[MAXSTARTTASKS];
+static int              starttaskdepth;
+
 dboolean                realframe;
 
 void D_CheckNetGame(void);
@@ -214,7 +251,7 @@ void D_Display(void)
     }
 
     // save the current screen if about to wipe
-    if ((wipe = (gamestate != wipegamestate || forcewipe)))
+    if ((wipe = ((gamestate != wipegamestate || forcewipe) && !benchmark)))
     {
         wipe_StartScreen();
         if (forcewipe)
@@ -226,7 +263,7 @@ void D_Display(void)
     if (gamestate != GS_LEVEL)
     {
         if (gamestate != oldgamestate && !splashscreen)
-            I_SetPalette(W_CacheLumpName("PLAYPAL", PU_CACHE));
+            I_SetPalette(W_CacheLumpRef(&playpalref, PU_CACHE));
 
         switch (gamestate)
         {
@@ -293,7 +330,7 @@ void D_Display(void)
         M_DarkBackground();
         if (M_PAUSE)
         {
-            patch_t     *patch = W_CacheLumpName("M_PAUSE", PU_CACHE);
+            patch_t     *patch = W_CacheLumpRef(&pauseref, PU_CACHE);
 
             if (vid_widescreen)
                 V_DrawPatchWithShadow((ORIGINALWIDTH - SHORT(patch->width)) / 2,
@@ -353,6 +390,86 @@ void D_Display(void)
         G_LoadedGameMessage();
 }
 
+//
+//  BENCHMARK
+//
+// When started with -benchmark or -timedemo, the game runs without a window,
+// one tic is run for every frame without waiting for real time to pass, and
+// the time taken by each frame in a level is recorded.
+//
+#define BENCHMARKTICS   (60 * TICRATE)
+
+static int              benchmarktics;
+static uint64_t         *frametimes;
+static int              numframetimes;
+static int              maxframetimes;
+static uint64_t         framestarttime;
+static uint64_t         ticendtime;
+static uint64_t         totaltictime;
+
+static int D_CompareFrameTimes(const void *a, const void *b)
+{
+    const uint64_t      x = *(const uint64_t *)a;
+    const uint64_t      y = *(const uint64_t *)b;
+
+    return ((x > y) - (x < y));
+}
+
+void D_EndBenchmark(void)
+{
+    uint64_t    total = 0;
+    int         i;
+    char        buffer[256] = "No frames were rendered.";
+
+    if (numframetimes)
+    {
+        for (i = 0; i < numframetimes; ++i)
+            total += frametimes[i];
+
+        qsort(frametimes, numframetimes, sizeof(*frametimes), D_CompareFrameTimes);
+
+        M_snprintf(buffer, sizeof(buffer), "Rendered %s frames in %.3fms (%.1f FPS). Each frame "
+            "took a minimum of %.3fms, an average of %.3fms and a 99th percentile of %.3fms, "
+            "and each tic took an average of %.3fms.",
+            commify(numframetimes), total / 1000.0, numframetimes * 1000000.0 / total,
+            frametimes[0] / 1000.0, total / 1000.0 / numframetimes,
+            frametimes[(numframetimes * 99 + 99) / 100 - 1] / 1000.0,
+            totaltictime / 1000.0 / numframetimes);
+    }
+
+    C_Output(buffer);
+    fprintf(stdout, "%s\n", buffer);
+    fflush(stdout);
+
+    I_Quit(true);
+}
+
+static void D_EndBenchmarkFrame(void)
+{
+    uint64_t    frametime = I_GetTimeUS() - framestarttime;
+
+    // Only frames rendered while in a level are counted. If the level is
+    // exited before enough frames have been rendered, stop there, unless a
+    // demo is being timed, which stops when it ends.
+    if (gamestate != GS_LEVEL)
+    {
+        if (numframetimes && !demoplayback)
+            D_EndBenchmark();
+        return;
+    }
+
+    if (numframetimes == maxframetimes)
+    {
+        maxframetimes = (maxframetimes ? maxframetimes * 2 : MIN(benchmarktics, BENCHMARKTICS));
+        frametimes = realloc(frametimes, maxframetimes * sizeof(*frametimes));
+    }
+    frametimes[numframetimes++] = frametime;
+    totaltictime += ticendtime - framestarttime;
+
+    if (numframetimes == benchmarktics)
+        D_EndBenchmark();
+}
+
 //
 //  D_DoomLoop
 //
@@ -366,14 +483,23 @@ void D_DoomLoop(void)
 
     while (1)
     {
+        if (benchmark)
+            framestarttime = I_GetTimeUS();
+
         TryRunTics(); // will run at least one tic
 
+        if (benchmark)
+            ticendtime = I_GetTimeUS();
+
         if (players[0].mo)
             S_UpdateSounds(players[0].mo);  // move positional sounds
 
         // Update display, next frame, with current state.
         if (screenvisible)
             D_Display();
+
+        if (benchmark)
+            D_EndBenchmarkFrame();
     }
 }
 
@@ -1243,6 +1369,209 @@ static void D_ProcessDehInWad(void)
             ProcessDehFile(NULL, i);
 }
 
+// Returns NULL if there are too many stages to time.
+static starttask_t *D_NewStartTask(char *name, char *parm, void (*func)(void))
+{
+    starttask_t *task;
+
+    if (numstarttasks == MAXSTARTTASKS)
+        return NULL;
+
+    task = &starttasks[numstarttasks++];
+    M_snprintf(task->name, sizeof(task->name), "%s(%s)", name, (parm ? parm : ""));
+    task->func = func;
+    task->thread = NULL;
+    task->threaded = false;
+    task->depth = starttaskdepth;
+    return task;
+}
+
+static int D_RunStartTask(void *data)
+{
+    starttask_t *task = data;
+
+    task->start = I_GetTimeUS();
+    task->func();
+    task->end = I_GetTimeUS();
+    return 0;
+}
+
+//
+// D_BeginTask
+// Begins timing a stage of startup on the main thread, until D_EndTask() is
+// called. parm, if not NULL, is shown with the name of the stage.
+//
+void D_BeginTask(char *name, char *parm)
+{
+    starttask_t *task = D_NewStartTask(name, parm, NULL);
+
+    if (task)
+    {
+        task->zonebytes = zonebytes;
+        task->pagefaults = I_GetPageFaults();
+        task->start = I_GetTimeUS();
+    }
+
+    starttaskstack[starttaskdepth++] = (task ? task - starttasks : -1);
+}
+
+//
+// D_EndTask
+// Ends the stage of startup last begun with D_BeginTask().
+//
+void D_EndTask(void)
+{
+    int i = starttaskstack[--starttaskdepth];
+
+    if (i >= 0)
+    {
+        starttask_t     *task = &starttasks[i];
+
+        task->end = I_GetTimeUS();
+        task->zonebytes = zonebytes - task->zonebytes;
+        task->pagefaults = I_GetPageFaults() - task->pagefaults;
+    }
+}
+
+//
+// D_RunTask
+// Runs a stage of startup now, on the main thread.
+//
+void D_RunTask(char *name, void (*func)(void))
+{
+    D_BeginTask(name, NULL);
+    func();
+    D_EndTask();
+}
+
+//
+// D_StartTask
+// Starts a stage of startup on its own thread, which D_WaitForTasks() joins. It
+// must not touch the zone memory, the WADs or the console, and nothing it
+// initializes may be used until then.
+//
+void D_StartTask(char *name, void (*func)(void))
+{
+    starttask_t *task;
+
+    if (SDL_GetCPUCount() > 1 && (task = D_NewStartTask(name, NULL, func)))
+    {
+        if ((task->thread = SDL_CreateThread(D_RunStartTask, name, task)))
+        {
+            task->threaded = true;
+            return;
+        }
+        --numstarttasks;
+    }
+
+    D_RunTask(name, func);
+}
+
+//
+// D_WaitForTasks
+// Waits for all of the stages of startup running on their own threads to finish.
+//
+void D_WaitForTasks(void)
+{
+    int i;
+
+    for (i = 0; i < numstarttasks; i++)
+        if (starttasks[i].thread)
+        {
+            SDL_WaitThread(starttasks[i].thread, NULL);
+            starttasks[i].thread = NULL;
+        }
+}
+
+static uint64_t D_FirstStartTime(void)
+{
+    uint64_t    first = starttasks[0].start;
+    int         i;
+
+    for (i = 1; i < numstarttasks; i++)
+        if (starttasks[i].start < first)
+            first = starttasks[i].start;
+
+    return first;
+}
+
+static void D_PrintStartTimes(void)
+{
+    int         tabs[8] = { 190, 240, 305, 370, 445, 0, 0, 0 };
+    uint64_t    first = D_FirstStartTime();
+    int         i;
+
+    C_TabbedOutput(tabs, "Stage\tThread\tStarted\tTook\tZone growth\tFaults");
+
+    for (i = 0; i < numstarttasks; i++)
+    {
+        starttask_t     *task = &starttasks[i];
+        char            indent[32];
+
+        M_snprintf(indent, sizeof(indent), "%*s", MIN(task->depth * 2, sizeof(indent) - 1), "");
+
+        if (task->threaded)
+            C_TabbedOutput(tabs, "%s%s\tWorker\t%.1fms\t%.1fms\t-\t-", indent, task->name,
+                (task->start - first) / 1000.0, (task->end - task->start) / 1000.0);
+        else
+            C_TabbedOutput(tabs, "%s%s\tMain\t%.1fms\t%.1fms\t%sKB\t%s", indent, task->name,
+                (task->start - first) / 1000.0, (task->end - task->start) / 1000.0,
+                commify((int)(task->zonebytes / 1024)), commify(task->pagefaults));
+    }
+
+    C_Output("Zone growth and faults are for the whole process, including any worker threads.");
+}
+
+//
+// D_WriteStartTrace
+// Writes the stages of startup to a file in the Chrome trace event format,
+// which can be opened in chrome://tracing.
+//
+static void D_WriteStartTrace(char *filename)
+{
+    FILE        *file = fopen(filename, "wt");
+    uint64_t    first = D_FirstStartTime();
+    int         i;
+
+    if (!file)
+    {
+        C_Warning("%s couldn't be written.", uppercase(filename));
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    for (i = 0; i < numstarttasks; i++)
+    {
+        starttask_t     *task = &starttasks[i];
+
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%lu,\"dur\":%lu",
+            (i ? ",\n" : ""), task->name, (task->threaded ? i + 2 : 1),
+            (unsigned long)(task->start - first), (unsigned long)(task->end - task->start));
+        if (!task->threaded)
+            fprintf(file, ",\"args\":{\"processzonegrowth\":%lu,\"processpagefaults\":%i}",
+                (unsigned long)task->zonebytes, task->pagefaults);
+        fprintf(file, "}");
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    C_Output("The stages of startup were written to %s.", uppercase(filename));
+}
+
+static byte     tinttabpalette[256 * 3];
+
+static void D_InitTintTables(void)
+{
+    I_InitTintTables(tinttabpalette);
+}
+
+static void D_InitSound(void)
+{
+    S_Init((int)(sfxVolume * 127.0f / 15.0f), (int)(musicVolume * 127.0f / 15.0f));
+}
+
 //
 // D_DoomMainSetup
 //
@@ -1278,6 +1607,47 @@ static void D_DoomMainSetup(void)
 
     devparm = M_CheckParm("-devparm");
 
+    p = M_CheckParm("-benchmark");
+    if (p)
+    {
+        benchmark = true;
+        benchmarktics = BENCHMARKTICS;
+        if (p < myargc - 1 && myargv[p + 1][0] != '-')
+            benchmarktics = MAX(1, atoi(myargv[p + 1]));
+        C_Output("Found -BENCHMARK parameter on command-line. %s frames will be rendered "
+            "without a window.", commify(benchmarktics));
+    }
+    else if ((p = M_CheckParmWithArgs("-timedemo", 1)))
+    {
+        benchmark = true;
+        benchmarktics = INT_MAX;
+        C_Output("Found -TIMEDEMO parameter on command-line. The demo will be played back "
+            "without a window.");
+    }
+    else if ((drawbench = M_CheckParm("-drawbench")))
+    {
+        benchmark = true;
+        C_Output("Found -DRAWBENCH parameter on command-line. The column and span drawers, and "
+            "nearest color lookups, will be timed without a window.");
+    }
+
+    if ((starttimes = M_CheckParm("-starttimes")))
+        C_Output("Found -STARTTIMES parameter on command-line. The time each stage of startup "
+            "takes will be shown.");
+
+    //!
+    // @arg <file>
+    //
+    // Write the stages of startup to a file that can be opened in
+    // chrome://tracing.
+    //
+    if ((p = M_CheckParmWithArgs("-starttrace", 1)))
+    {
+        starttrace = myargv[p + 1];
+        C_Output("Found -STARTTRACE parameter on command-line. The stages of startup will be "
+            "written to %s.", uppercase(starttrace));
+    }
+
     // turbo option
     p = M_CheckParm("-turbo");
     if (p)
@@ -1415,13 +1785,17 @@ static void D_DoomMainSetup(void)
 
     D_IdentifyVersion();
     InitGameVersion();
-    D_ProcessDehInWad();
+    D_RunTask("D_ProcessDehInWad", D_ProcessDehInWad);
     D_SetGameDescription();
     D_SetSaveGameFolder();
 
     I_InitGamepad();
 
-    I_InitGraphics();
+    // the tint tables aren't needed until the first frame is drawn
+    memcpy(tinttabpalette, W_CacheLumpName("PLAYPAL", PU_CACHE), sizeof(tinttabpalette));
+    D_StartTask("I_InitTintTables", D_InitTintTables);
+
+    D_RunTask("I_InitGraphics", I_InitGraphics);
 
     // Check for -file in shareware
     if (modifiedgame)
@@ -1599,23 +1973,34 @@ static void D_DoomMainSetup(void)
     P_BloodSplatSpawner = (r_blood == noblood || !r_bloodsplats_max ? P_NullBloodSplatSpawner :
         (r_bloodsplats_max == unlimited ? P_SpawnBloodSplat : P_SpawnBloodSplat2));
 
-    M_Init();
+    D_RunTask("M_Init", M_Init);
 
-    R_Init();
+    D_RunTask("R_Init", R_Init);
 
-    P_Init();
+    if (drawbench)
+    {
+        D_WaitForTasks();
+        R_ExecuteSetViewSize();
+        R_BenchmarkDrawers();
+        I_BenchmarkNearestColor(W_CacheLumpName("PLAYPAL", PU_CACHE));
+        I_Quit(false);
+    }
 
-    S_Init((int)(sfxVolume * 127.0f / 15.0f), (int)(musicVolume * 127.0f / 15.0f));
+    D_RunTask("P_Init", P_Init);
+
+    D_RunTask("S_Init", D_InitSound);
 
     D_CheckNetGame();
 
-    HU_Init();
+    D_RunTask("HU_Init", HU_Init);
+
+    D_RunTask("ST_Init", ST_Init);
 
-    ST_Init();
+    D_RunTask("AM_Init", AM_Init);
 
-    AM_Init();
+    D_RunTask("C_Init", C_Init);
 
-    C_Init();
+    D_WaitForTasks();
 
     if (startloadgame >= 0)
     {
@@ -1632,7 +2017,33 @@ static void D_DoomMainSetup(void)
     creditlump = W_CacheLumpName("CREDIT", PU_CACHE);
     playpal = W_CacheLumpName("PLAYPAL", PU_CACHE);
 
-    if (gameaction != ga_loadgame)
+    p = M_CheckParmWithArgs("-record", 1);
+    if (p)
+    {
+        C_Output("Found -RECORD parameter on command-line.");
+        G_RecordDemo(myargv[p + 1]);
+    }
+
+    p = M_CheckParmsWithArgs("-playdemo", "-timedemo", 1);
+    if (p)
+    {
+        if (!benchmark)
+            C_Output("Found -PLAYDEMO parameter on command-line.");
+        noinput = false;
+        G_DeferredPlayDemo(myargv[p + 1]);
+    }
+
+    // a benchmark or a demo being recorded always starts in a level
+    if ((benchmark || demorecording) && !autostart && gameaction == ga_nothing)
+    {
+        if (gamemode == commercial)
+            M_snprintf(lumpname, sizeof(lumpname), "MAP%02i", startmap);
+        else
+            M_snprintf(lumpname, sizeof(lumpname), "E%iM%i", startepisode, startmap);
+        autostart = true;
+    }
+
+    if (gameaction == ga_nothing)
     {
         if (autostart)
         {
@@ -1654,6 +2065,9 @@ static void D_DoomMainSetup(void)
         (startuptimer / 1000) % 60,
         (startuptimer % 1000) / 10);
 
+    // only count the lumps looked up by name from now on
+    lumplookups = 0;
+
     // Ty 04/08/98 - Add 5 lines of misc. data, only if nonblank
     // The expectation is that these will be set in a .bex file
     if (*startup1 || *startup2 || *startup3 || *startup4 || *startup5)
@@ -1677,7 +2091,14 @@ static void D_DoomMainSetup(void)
 //
 void D_DoomMain(void)
 {
+    D_BeginTask("D_DoomMain", NULL);
     D_DoomMainSetup();          // CPhipps - setup out of main execution stack
+    D_EndTask();
+
+    if (starttimes)
+        D_PrintStartTimes();
+    if (starttrace)
+        D_WriteStartTrace(starttrace);
 
     D_DoomLoop();               // never returns
 }
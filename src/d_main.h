@@ -67,4 +67,14 @@ void D_AdvanceTitle(void);
 void D_DoAdvanceTitle(void);
 void D_StartTitle(int page);
 
+// Prints the results of -benchmark or -timedemo and quits.
+void D_EndBenchmark(void);
+
+// Stages of startup, timed for -starttimes.
+void D_BeginTask(char *name, char *parm);
+void D_EndTask(void);
+void D_RunTask(char *name, void (*func)(void));
+void D_StartTask(char *name, void (*func)(void));
+void D_WaitForTasks(void);
+
 #endif
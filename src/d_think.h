@@ -71,6 +71,9 @@ typedef struct thinker_s
     // killough 11/98: count of how many other objects reference
     // this one using pointers. Used for garbage collection.
     unsigned int        references;
+
+    // The pool the thinker was allocated from.
+    int                 pool;
 } thinker_t;
 
 #endif
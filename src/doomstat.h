@@ -55,6 +55,8 @@ extern  dboolean        fastparm;       // checkparm of -fast
 
 extern  dboolean        devparm;        // DEBUG: launched with -devparm
 
+extern  dboolean        benchmark;      // checkparm of -benchmark
+
 // -----------------------------------------------------
 // Game Mode - identify IWAD as shareware, retail etc.
 //
@@ -171,6 +173,10 @@ extern int              leveltime;      // tics in game play for par
 
 extern dboolean         usergame;
 
+// Demo recording and playback.
+extern dboolean         demorecording;
+extern dboolean         demoplayback;
+
 //?
 extern gamestate_t      gamestate;
 
@@ -75,4 +75,11 @@ typedef uint8_t byte;
 
 #define arrlen(array) (sizeof(array) / sizeof(*array))
 
+// Each thread has its own copy of a variable declared with THREADLOCAL.
+#if defined(_MSC_VER)
+#define THREADLOCAL     __declspec(thread)
+#else
+#define THREADLOCAL     __thread
+#endif
+
 #endif
@@ -731,7 +731,10 @@ void F_CastDrawer(void)
     int                 rot = 0;
     dboolean            flip;
     patch_t             *patch;
+    int                 x = ORIGINALWIDTH / 2;
     int                 y = ORIGINALHEIGHT - 30;
+    int                 shadowy = ORIGINALHEIGHT - 28;
+    int                 topoffset;
     mobjtype_t          type = castorder[castnum].type;
 
     // erase the entire screen to a background
@@ -749,7 +752,11 @@ void F_CastDrawer(void)
 
     patch = W_CacheLumpNum(lump + firstspritelump, PU_CACHE);
 
-    patch->topoffset = spritetopoffset[lump] >> FRACBITS;
+    // The lump may be in a read-only mapping, so rather than change the offsets
+    // in its header, move where it's drawn by the difference.
+    topoffset = spritetopoffset[lump] >> FRACBITS;
+    y += SHORT(patch->topoffset) - topoffset;
+    shadowy += SHORT(patch->topoffset) / 10 - topoffset / 10;
 
     if (type == MT_SKULL)
         y -= 30;
@@ -758,51 +765,51 @@ void F_CastDrawer(void)
 
     if (flip || castdeathflip)
     {
-        patch->leftoffset = (spritewidth[lump] - spriteoffset[lump]) >> FRACBITS;
+        x += SHORT(patch->leftoffset) - ((spritewidth[lump] - spriteoffset[lump]) >> FRACBITS);
 
         if (r_shadows && ((type != MT_SKULL && type != MT_PAIN) || !castdeath))
         {
             if (r_translucency)
             {
                 if (type == MT_SHADOWS)
-                    V_DrawFlippedSpectreShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                    V_DrawFlippedSpectreShadowPatch(x, shadowy, patch);
                 else
-                    V_DrawFlippedShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                    V_DrawFlippedShadowPatch(x, shadowy, patch);
             }
             else
-                V_DrawFlippedSolidShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                V_DrawFlippedSolidShadowPatch(x, shadowy, patch);
         }
 
         if (r_translucency && (type == MT_SKULL || (type == MT_PAIN && castdeath)))
-            V_DrawFlippedTranslucentRedPatch(ORIGINALWIDTH / 2, y, patch);
+            V_DrawFlippedTranslucentRedPatch(x, y, patch);
         else if (type == MT_SHADOWS)
-            V_DrawFlippedFuzzPatch(ORIGINALWIDTH / 2, y, patch);
+            V_DrawFlippedFuzzPatch(x, y, patch);
         else
-            V_DrawFlippedPatch(ORIGINALWIDTH / 2, y, patch);
+            V_DrawFlippedPatch(x, y, patch);
     }
     else
     {
-        patch->leftoffset = spriteoffset[lump] >> FRACBITS;
+        x += SHORT(patch->leftoffset) - (spriteoffset[lump] >> FRACBITS);
 
         if (r_shadows && ((type != MT_SKULL && type != MT_PAIN) || !castdeath))
         {
             if (r_translucency)
             {
                 if (type == MT_SHADOWS)
-                    V_DrawSpectreShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                    V_DrawSpectreShadowPatch(x, shadowy, patch);
                 else
-                    V_DrawShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                    V_DrawShadowPatch(x, shadowy, patch);
             }
             else
-                V_DrawSolidShadowPatch(ORIGINALWIDTH / 2, ORIGINALHEIGHT - 28, patch);
+                V_DrawSolidShadowPatch(x, shadowy, patch);
         }
 
         if (r_translucency && (type == MT_SKULL || (type == MT_PAIN && castdeath)))
-            V_DrawTranslucentRedPatch(ORIGINALWIDTH / 2, y, patch);
+            V_DrawTranslucentRedPatch(x, y, patch);
         else if (type == MT_SHADOWS)
-            V_DrawFuzzPatch(ORIGINALWIDTH / 2, y, patch);
+            V_DrawFuzzPatch(x, y, patch);
         else
-            V_DrawPatch(ORIGINALWIDTH / 2, y, 0, patch);
+            V_DrawPatch(x, y, 0, patch);
     }
 }
 
@@ -839,6 +846,14 @@ void F_DrawPatchCol(int x, patch_t *patch, int col, fixed_t fracstep)
     }
 }
 
+static lumpref_t pfub1ref = LUMPREF("PFUB1");
+static lumpref_t pfub2ref = LUMPREF("PFUB2");
+static lumpref_t endrefs[] =
+{
+    LUMPREF("END0"), LUMPREF("END1"), LUMPREF("END2"), LUMPREF("END3"),
+    LUMPREF("END4"), LUMPREF("END5"), LUMPREF("END6")
+};
+
 //
 // F_BunnyScroll
 //
@@ -848,15 +863,14 @@ void F_BunnyScroll(void)
     int                 x;
     patch_t             *p1;
     patch_t             *p2;
-    char                name[10];
     int                 stage;
     static int          laststage;
     const fixed_t       yscale = (ORIGINALHEIGHT << FRACBITS) / SCREENHEIGHT;
     const fixed_t       xscale = (ORIGINALWIDTH << FRACBITS) / SCREENWIDTH;
     fixed_t             frac = 0;
 
-    p1 = W_CacheLumpName("PFUB2", PU_LEVEL);
-    p2 = W_CacheLumpName("PFUB1", PU_LEVEL);
+    p1 = W_CacheLumpRef(&pfub2ref, PU_LEVEL);
+    p2 = W_CacheLumpRef(&pfub1ref, PU_LEVEL);
 
     scrolled = ORIGINALWIDTH - ((signed int)finalecount - 230) / 2;
     if (scrolled > ORIGINALWIDTH)
@@ -882,7 +896,7 @@ void F_BunnyScroll(void)
     if (finalecount < 1180)
     {
         V_DrawPatchWithShadow((ORIGINALWIDTH - 13 * 8) / 2 + 1, (ORIGINALHEIGHT - 8 * 8) / 2 + 1,
-            W_CacheLumpName("END0", PU_CACHE), false);
+            W_CacheLumpRef(&endrefs[0], PU_CACHE), false);
         laststage = 0;
         return;
     }
@@ -896,9 +910,8 @@ void F_BunnyScroll(void)
         laststage = stage;
     }
 
-    M_snprintf(name, 10, "END%i", stage);
     V_DrawPatchWithShadow((ORIGINALWIDTH - 13 * 8) / 2 + 1, (ORIGINALHEIGHT - 8 * 8) / 2 + 1,
-        W_CacheLumpName(name, PU_CACHE), false);
+        W_CacheLumpRef(&endrefs[stage], PU_CACHE), false);
 }
 
 static void F_ArtScreenDrawer(void)
@@ -68,6 +68,7 @@
 #include "SDL.h"
 #include "st_stuff.h"
 #include "v_video.h"
+#include "version.h"
 #include "w_wad.h"
 #include "wi_stuff.h"
 #include "z_zone.h"
@@ -83,6 +84,9 @@ void G_DoVictory(void);
 void G_DoWorldDone(void);
 void G_DoSaveGame(void);
 
+static void G_ReadDemoTiccmd(ticcmd_t *cmd);
+static void G_WriteDemoTiccmd(ticcmd_t *cmd);
+
 // Gamestate the last time G_Ticker was called.
 
 gamestate_t     oldgamestate;
@@ -99,6 +103,9 @@ dboolean        sendpause;              // send a pause event next tic
 dboolean        sendsave;               // send a save event next tic
 dboolean        usergame;               // ok to save / end game
 
+dboolean        demorecording;
+dboolean        demoplayback;
+
 dboolean        viewactive;
 
 player_t        players[MAXPLAYERS];
@@ -596,6 +603,11 @@ void G_DoLoadLevel(void)
 
     M_ClearRandom();
 
+    // make the randomness that isn't part of the play simulation repeatable
+    // so a demo looks the same every time it is played back
+    if (demorecording || demoplayback)
+        M_SeedRandom(gamemap);
+
     // initialize the msecnode_t freelist.                     phares 3/25/98
     // any nodes in the freelist are gone by now, cleared
     // by Z_FreeTags() when the previous level ended or player
@@ -902,6 +914,9 @@ void G_Ticker(void)
             case ga_worlddone:
                 G_DoWorldDone();
                 break;
+            case ga_playdemo:
+                G_DoPlayDemo();
+                break;
             case ga_screenshot:
                 if (gametic)
                 {
@@ -938,6 +953,11 @@ void G_Ticker(void)
     cmd = &players[0].cmd;
     memcpy(cmd, &netcmds[(gametic / ticdup) % BACKUPTICS], sizeof(ticcmd_t));
 
+    if (demoplayback)
+        G_ReadDemoTiccmd(cmd);
+    if (demorecording)
+        G_WriteDemoTiccmd(cmd);
+
     // check for special buttons
     if (players[0].cmd.buttons & BT_SPECIAL)
     {
@@ -1656,6 +1676,8 @@ void G_DoNewGame(void)
 
     st_facecount = ST_STRAIGHTFACECOUNT;
     G_InitNew(d_skill, d_episode, d_map);
+    if (demorecording)
+        G_BeginRecording();
     gameaction = ga_nothing;
     markpointnum = 0;
     infight = false;
@@ -1738,3 +1760,211 @@ void G_InitNew(skill_t skill, int ep, int map)
 
     G_DoLoadLevel();
 }
+
+//
+// DEMO RECORDING
+//
+// A demo starts with a header giving the skill level, episode, map and
+// expansion it was recorded in, a hash of the configuration, and the state
+// of P_Random() and M_RandomInt() once the map was loaded. This is followed
+// by every ticcmd_t in full, and then DEMOMARKER.
+//
+#define DEMOMARKER      0x80
+#define DEMOVERSION     2
+#define DEMOHEADERSIZE  19
+#define DEMOTICCMDSIZE  5
+
+static char     *demoname;
+static byte     *demobuffer;
+static byte     *demo_p;
+static byte     *demoend;
+
+static char *G_DemoFilename(char *name)
+{
+    return (M_StringEndsWith(name, ".lmp") ? strdup(name) : M_StringJoin(name, ".lmp", NULL));
+}
+
+static void G_ReadDemoTiccmd(ticcmd_t *cmd)
+{
+    if (*demo_p == DEMOMARKER || demo_p + DEMOTICCMDSIZE > demoend)
+    {
+        // end of demo data stream
+        G_CheckDemoStatus();
+        return;
+    }
+
+    cmd->forwardmove = (signed char)*demo_p++;
+    cmd->sidemove = (signed char)*demo_p++;
+    cmd->angleturn = (short)(demo_p[0] | (demo_p[1] << 8));
+    demo_p += 2;
+    cmd->buttons = *demo_p++;
+}
+
+static void G_WriteDemoTiccmd(ticcmd_t *cmd)
+{
+    // not recording until a new game has started
+    if (!demo_p)
+        return;
+
+    // leave room for the marker at the end
+    if (demo_p + DEMOTICCMDSIZE + 1 > demoend)
+    {
+        size_t  length = demo_p - demobuffer;
+        size_t  size = (demoend - demobuffer) * 2;
+
+        demobuffer = realloc(demobuffer, size);
+        demo_p = demobuffer + length;
+        demoend = demobuffer + size;
+    }
+
+    *demo_p++ = (byte)cmd->forwardmove;
+    *demo_p++ = (byte)cmd->sidemove;
+    *demo_p++ = (byte)(cmd->angleturn & 0xFF);
+    *demo_p++ = (byte)((cmd->angleturn >> 8) & 0xFF);
+    *demo_p++ = cmd->buttons;
+}
+
+//
+// G_RecordDemo
+//
+void G_RecordDemo(char *name)
+{
+    size_t      size = 0x20000;
+
+    demoname = G_DemoFilename(name);
+    demobuffer = malloc(size);
+    demoend = demobuffer + size;
+    demo_p = NULL;
+    demorecording = true;
+}
+
+//
+// G_BeginRecording
+// Called when a new game starts, so starting another game from the menu
+// starts the demo again.
+//
+void G_BeginRecording(void)
+{
+    unsigned int        hash = M_CVARsHash();
+
+    demo_p = demobuffer;
+
+    *demo_p++ = 'D';
+    *demo_p++ = 'R';
+    *demo_p++ = 'D';
+    *demo_p++ = 'M';
+    *demo_p++ = DEMOVERSION;
+    *demo_p++ = gameskill;
+    *demo_p++ = gameepisode;
+    *demo_p++ = gamemap;
+    *demo_p++ = gamemission;
+    *demo_p++ = (nomonsters | (fastparm << 1));
+    *demo_p++ = hash & 0xFF;
+    *demo_p++ = (hash >> 8) & 0xFF;
+    *demo_p++ = (hash >> 16) & 0xFF;
+    *demo_p++ = (hash >> 24) & 0xFF;
+    *demo_p++ = prndindex;
+    *demo_p++ = rndseed & 0xFF;
+    *demo_p++ = (rndseed >> 8) & 0xFF;
+    *demo_p++ = (rndseed >> 16) & 0xFF;
+    *demo_p++ = (rndseed >> 24) & 0xFF;
+
+    C_Output("Recording a demo to %s.", uppercase(demoname));
+}
+
+//
+// G_DeferredPlayDemo
+//
+void G_DeferredPlayDemo(char *name)
+{
+    demoname = G_DemoFilename(name);
+    gameaction = ga_playdemo;
+}
+
+//
+// G_DoPlayDemo
+//
+void G_DoPlayDemo(void)
+{
+    int                 length;
+    skill_t             skill;
+    int                 episode;
+    int                 map;
+    unsigned int        hash;
+    int                 index;
+    unsigned int        seed;
+
+    gameaction = ga_nothing;
+
+    length = M_ReadFile(demoname, &demobuffer);
+    demoend = demobuffer + length;
+    demo_p = demobuffer;
+
+    if (length < DEMOHEADERSIZE || demo_p[0] != 'D' || demo_p[1] != 'R' || demo_p[2] != 'D'
+        || demo_p[3] != 'M')
+        I_Error("%s is not a "PACKAGE_NAME" demo.", uppercase(demoname));
+    if (demo_p[4] != DEMOVERSION)
+        I_Error("%s was recorded with an incompatible version of "PACKAGE_NAME".",
+            uppercase(demoname));
+    demo_p += 5;
+
+    skill = (skill_t)*demo_p++;
+    episode = *demo_p++;
+    map = *demo_p++;
+    gamemission = (GameMission_t)*demo_p++;
+    nomonsters = !!(*demo_p & 1);
+    fastparm = !!(*demo_p++ & 2);
+    hash = demo_p[0] | (demo_p[1] << 8) | (demo_p[2] << 16) | ((unsigned int)demo_p[3] << 24);
+    demo_p += 4;
+    index = *demo_p++;
+    seed = demo_p[0] | (demo_p[1] << 8) | (demo_p[2] << 16) | ((unsigned int)demo_p[3] << 24);
+    demo_p += 4;
+
+    C_Output("Playing back the demo %s.", uppercase(demoname));
+    if (hash != M_CVARsHash())
+        C_Warning("The demo was recorded with a different configuration.");
+
+    demoplayback = true;
+    G_InitNew(skill, episode, map);
+    usergame = false;
+
+    // carry on from the same random numbers as when the demo was recorded
+    prndindex = index;
+    rndseed = seed;
+}
+
+//
+// G_CheckDemoStatus
+// Called when a demo ends, or when quitting while recording.
+//
+void G_CheckDemoStatus(void)
+{
+    if (demoplayback)
+    {
+        demoplayback = false;
+
+        if (benchmark)
+            D_EndBenchmark();
+
+        C_Output("Finished playing back the demo %s.", uppercase(demoname));
+        I_Quit(true);
+    }
+
+    if (demorecording)
+    {
+        demorecording = false;
+
+        if (demo_p)
+        {
+            *demo_p++ = DEMOMARKER;
+            if (M_WriteFile(demoname, demobuffer, demo_p - demobuffer))
+                C_Output("Recorded the demo %s.", uppercase(demoname));
+            else
+                C_Warning("The demo %s couldn't be saved.", uppercase(demoname));
+        }
+
+        free(demobuffer);
+        demobuffer = NULL;
+        demo_p = NULL;
+    }
+}
@@ -76,6 +76,13 @@ void G_Ticker(void);
 dboolean G_Responder(event_t *ev);
 
 void G_ScreenShot(void);
+
+// Only called by startup code.
+void G_RecordDemo(char *name);
+void G_BeginRecording(void);
+void G_DeferredPlayDemo(char *name);
+void G_DoPlayDemo(void);
+void G_CheckDemoStatus(void);
 void ToggleWidescreen(dboolean toggle);
 
 extern dboolean canmodify;
@@ -45,6 +45,7 @@
 #include "m_fixed.h"
 #include "m_misc.h"
 #include "version.h"
+#include "z_zone.h"
 
 int     windowborderwidth = 0;
 int     windowborderheight = 0;
@@ -285,6 +286,8 @@ int main(int argc, char **argv)
     I_SetProcessDPIAware();
 #endif
 
+    Z_Init();
+
     D_DoomMain();
 
     return 0;
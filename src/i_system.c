@@ -45,10 +45,12 @@
 #if defined(WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <psapi.h>
 
 void I_ShutdownWindows32(void);
 #else
 #include <unistd.h>
+#include <sys/resource.h>
 #endif
 
 #include "c_console.h"
@@ -77,6 +79,7 @@ extern dboolean returntowidescreen;
 typedef long(__stdcall *PRTLGETVERSION)(PRTL_OSVERSIONINFOEXW);
 typedef BOOL(WINAPI *PGETPRODUCTINFO)(DWORD, DWORD, DWORD, DWORD, PDWORD);
 typedef BOOL(WINAPI *PISWOW64PROCESS)(HANDLE, PBOOL);
+typedef BOOL(WINAPI *PGETPROCESSMEMORYINFO)(HANDLE, PPROCESS_MEMORY_COUNTERS, DWORD);
 
 #define PRODUCT_PROFESSIONAL    0x00000030
 
@@ -221,11 +224,38 @@ void I_PrintWindowsVersion(void)
 }
 #endif
 
+//
+// I_GetPageFaults
+// Returns the number of page faults the process has had.
+//
+int I_GetPageFaults(void)
+{
+#if defined(WIN32)
+    PGETPROCESSMEMORYINFO       pGetProcessMemoryInfo = (PGETPROCESSMEMORYINFO)GetProcAddress(
+                                    GetModuleHandle("kernel32.dll"), "K32GetProcessMemoryInfo");
+    PROCESS_MEMORY_COUNTERS     counters;
+
+    if (pGetProcessMemoryInfo && pGetProcessMemoryInfo(GetCurrentProcess(), &counters,
+        sizeof(counters)))
+        return counters.PageFaultCount;
+    return 0;
+#else
+    struct rusage       usage;
+
+    if (!getrusage(RUSAGE_SELF, &usage))
+        return (int)(usage.ru_minflt + usage.ru_majflt);
+    return 0;
+#endif
+}
+
 //
 // I_Quit
 //
 void I_Quit(dboolean shutdown)
 {
+    if (demorecording)
+        G_CheckDemoStatus();
+
     if (shutdown)
     {
         S_Shutdown();
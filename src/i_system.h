@@ -59,4 +59,6 @@ void I_Error(char *error, ...);
 
 void I_PrintWindowsVersion(void);
 
+int I_GetPageFaults(void);
+
 #endif
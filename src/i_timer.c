@@ -69,6 +69,27 @@ int I_GetTimeMS(void)
     return (ticks - basetime);
 }
 
+//
+// Same as I_GetTimeMS, but returns time in microseconds using the
+// high-resolution performance counter
+//
+uint64_t I_GetTimeUS(void)
+{
+    static Uint64       basecounter = 0;
+    static Uint64       frequency = 0;
+    Uint64              counter = SDL_GetPerformanceCounter();
+
+    if (!frequency)
+    {
+        frequency = SDL_GetPerformanceFrequency();
+        basecounter = counter;
+    }
+
+    counter -= basecounter;
+
+    return (counter / frequency * 1000000 + counter % frequency * 1000000 / frequency);
+}
+
 //
 // Sleep for a specified number of ms
 //
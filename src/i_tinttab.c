@@ -36,9 +36,19 @@
 ========================================================================
 */
 
+#include "c_console.h"
+#include "i_timer.h"
+#include "i_tinttab.h"
 #include "m_fixed.h"
+#include "m_misc.h"
 #include "z_zone.h"
 
+// The tint tables are saved to this file, and loaded from it instead of being generated
+// again the next time, as long as the palette and the way they're generated are the same.
+#define TINTTABCACHE            "tinttabs.cache"
+#define TINTTABCACHEID          "DRTT"
+#define TINTTABCACHEVERSION     1
+
 #define ADDITIVE       -1
 
 #define R               1
@@ -128,9 +138,194 @@ int FindNearestColor(byte *palette, int red, int green, int blue)
     return best_color;
 }
 
-static byte *GenerateTintTable(byte *palette, int percent, byte filter[256], int colors)
+#define PALETTECELLS    (32 * 32 * 32)
+
+void I_InitPaletteIndex(paletteindex_t *index, byte *palette)
+{
+    int i;
+
+    memcpy(index->palette, palette, sizeof(index->palette));
+    index->cells = malloc(PALETTECELLS * sizeof(*index->cells));
+
+    for (i = 0; i < PALETTECELLS; ++i)
+        index->cells[i].count = -1;
+
+    index->candidates = NULL;
+    index->numcandidates = 0;
+    index->maxcandidates = 0;
+}
+
+void I_FreePaletteIndex(paletteindex_t *index)
+{
+    free(index->cells);
+    free(index->candidates);
+    index->cells = NULL;
+    index->candidates = NULL;
+}
+
+//
+// BuildPaletteCell
+// Lists the palette entries that could be nearest to any color in
+//  a cell. An entry can only be nearest if the closest it gets to
+//  the cell is no further than the entry furthest from the cell is
+//  at worst. The entries are kept in palette order, so that ties are
+//  resolved just as FindNearestColor() resolves them.
+//
+static void BuildPaletteCell(paletteindex_t *index, int cell)
+{
+    int         lo[3] = { (cell >> 10) << 3, ((cell >> 5) & 31) << 3, (cell & 31) << 3 };
+    int         mindist[256];
+    int         best = INT_MAX;
+    int         count = 0;
+    int         i;
+    int         j;
+
+    for (i = 0; i < 256; ++i)
+    {
+        byte    *color = index->palette + i * 3;
+        int     dmin = 0;
+        int     dmax = 0;
+
+        for (j = 0; j < 3; ++j)
+        {
+            int c = color[j] - lo[j];
+            int near = (c < 0 ? -c : (c > 7 ? c - 7 : 0));
+            int far = (c < 4 ? 7 - c : c);
+
+            dmin += near * near;
+            dmax += far * far;
+        }
+
+        mindist[i] = dmin;
+
+        if (dmax < best)
+            best = dmax;
+    }
+
+    if (index->numcandidates + 256 > index->maxcandidates)
+    {
+        index->maxcandidates = index->maxcandidates * 2 + 256;
+        index->candidates = realloc(index->candidates, index->maxcandidates);
+    }
+
+    for (i = 0; i < 256; ++i)
+        if (mindist[i] <= best)
+            index->candidates[index->numcandidates + count++] = i;
+
+    index->cells[cell].offset = index->numcandidates;
+    index->cells[cell].count = count;
+    index->numcandidates += count;
+}
+
+//
+// I_FindNearestColor
+// Returns the same color as FindNearestColor() does.
+//
+int I_FindNearestColor(paletteindex_t *index, int red, int green, int blue)
+{
+    int         cell;
+    byte        *candidate;
+    int         count;
+    int         best_difference = INT_MAX;
+    int         best_color = 0;
+
+    if ((red | green | blue) & ~255)
+        return FindNearestColor(index->palette, red, green, blue);
+
+    cell = ((red >> 3) << 10) | ((green >> 3) << 5) | (blue >> 3);
+
+    if (index->cells[cell].count < 0)
+        BuildPaletteCell(index, cell);
+
+    candidate = index->candidates + index->cells[cell].offset;
+    count = index->cells[cell].count;
+
+    while (count--)
+    {
+        byte    *color = index->palette + *candidate * 3;
+        int     r = red - color[0];
+        int     g = green - color[1];
+        int     b = blue - color[2];
+        int     difference = r * r + g * g + b * b;
+
+        if (difference < best_difference)
+        {
+            if (!difference)
+                return *candidate;
+
+            best_color = *candidate;
+            best_difference = difference;
+        }
+        ++candidate;
+    }
+    return best_color;
+}
+
+static void ReportNearestColorBenchmark(const char *name, int lookups, uint64_t time)
+{
+    char        buffer[256];
+
+    M_snprintf(buffer, sizeof(buffer), "%s found the nearest colors to %s colors in %.3fms.",
+        name, commify(lookups), time / 1000.0);
+
+    C_Output(buffer);
+    fprintf(stdout, "%s\n", buffer);
+    fflush(stdout);
+}
+
+//
+// I_BenchmarkNearestColor
+// Times FindNearestColor() against I_FindNearestColor() over a
+//  spread of colors, and checks that they agree.
+//
+void I_BenchmarkNearestColor(byte *palette)
+{
+    paletteindex_t  index;
+    uint64_t        start;
+    int             lookups = 0;
+    int             mismatches = 0;
+    int             checksum1 = 0;
+    int             checksum2 = 0;
+    int             r, g, b;
+
+    start = I_GetTimeUS();
+
+    for (r = 0; r < 256; r += 3)
+        for (g = 0; g < 256; g += 3)
+            for (b = 0; b < 256; b += 3)
+            {
+                checksum1 += FindNearestColor(palette, r, g, b);
+                ++lookups;
+            }
+
+    ReportNearestColorBenchmark("FindNearestColor()", lookups, I_GetTimeUS() - start);
+
+    start = I_GetTimeUS();
+    I_InitPaletteIndex(&index, palette);
+
+    for (r = 0; r < 256; r += 3)
+        for (g = 0; g < 256; g += 3)
+            for (b = 0; b < 256; b += 3)
+                checksum2 += I_FindNearestColor(&index, r, g, b);
+
+    ReportNearestColorBenchmark("I_FindNearestColor()", lookups, I_GetTimeUS() - start);
+
+    for (r = 0; r < 256; r += 3)
+        for (g = 0; g < 256; g += 3)
+            for (b = 0; b < 256; b += 3)
+                mismatches += (FindNearestColor(palette, r, g, b) != I_FindNearestColor(&index, r, g, b));
+
+    I_FreePaletteIndex(&index);
+
+    if (mismatches || checksum1 != checksum2)
+        C_Warning("I_FindNearestColor() disagreed with FindNearestColor() %s times.",
+            commify(mismatches));
+}
+
+static void GenerateTintTable(byte *result, paletteindex_t *index, int percent, byte filter[256],
+    int colors)
 {
-    byte        *result = Z_Malloc(65536, PU_STATIC, NULL);
+    byte        *palette = index->palette;
     int         foreground, background;
 
     for (foreground = 0; foreground < 256; ++foreground)
@@ -167,7 +362,7 @@ static byte *GenerateTintTable(byte *palette, int percent, byte filter[256], int
                     g = ((int)color1[1] * percent + (int)color2[1] * (100 - percent)) / (100 + blues);
                     b = ((int)color1[2] * percent + (int)color2[2] * (100 - percent)) / 100;
                 }
-                *(result + (background << 8) + foreground) = FindNearestColor(palette, r, g, b);
+                *(result + (background << 8) + foreground) = I_FindNearestColor(index, r, g, b);
             }
         }
         else
@@ -179,30 +374,140 @@ static byte *GenerateTintTable(byte *palette, int percent, byte filter[256], int
         *(result + (77 << 8) + 109) = *(result + (109 << 8) + 77) = 77;
         *(result + (78 << 8) + 109) = *(result + (109 << 8) + 78) = 109;
     }
+}
+
+static struct
+{
+    byte        **table;
+    int         percent;
+    int         colors;
+} tinttabs[] =
+{
+    { &tinttab,           ADDITIVE, ALL                       },
+    { &tinttab25,         25,       ALL                       },
+    { &tinttab33,         33,       ALL                       },
+    { &tinttab40,         40,       ALL                       },
+    { &tinttab50,         50,       ALL                       },
+    { &tinttab60,         60,       ALL                       },
+    { &tinttab66,         66,       ALL                       },
+    { &tinttab75,         75,       ALL                       },
+    { &tinttab80,         80,       ALL                       },
+    { &tinttabred,        ADDITIVE, REDS                      },
+    { &tinttabredwhite1,  ADDITIVE, (REDS | WHITES)           },
+    { &tinttabredwhite2,  ADDITIVE, (REDS | WHITES | EXTRAS)  },
+    { &tinttabgreen,      ADDITIVE, GREENS                    },
+    { &tinttabblue,       ADDITIVE, BLUES                     },
+    { &tinttabred33,      33,       REDS                      },
+    { &tinttabredwhite50, 50,       (REDS | WHITES)           },
+    { &tinttabgreen33,    33,       GREENS                    },
+    { &tinttabblue33,     33,       BLUES                     }
+};
+
+#define NUMTINTTABS     (sizeof(tinttabs) / sizeof(tinttabs[0]))
+
+typedef struct
+{
+    char        id[4];
+    uint32_t    version;
+    uint32_t    hash;
+    uint32_t    numtinttabs;
+} tinttabcacheheader_t;
+
+// FNV-1a
+static uint32_t HashTintTableData(uint32_t hash, const byte *data, size_t length)
+{
+    while (length--)
+    {
+        hash ^= *data++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//
+// HashTintTables
+// Hashes everything the tint tables are generated from.
+//
+static uint32_t HashTintTables(byte *palette)
+{
+    uint32_t    hash = HashTintTableData(2166136261u, palette, 256 * 3);
+    size_t      i;
+
+    hash = HashTintTableData(hash, general, sizeof(general));
+
+    for (i = 0; i < NUMTINTTABS; i++)
+    {
+        hash = HashTintTableData(hash, (byte *)&tinttabs[i].percent, sizeof(tinttabs[i].percent));
+        hash = HashTintTableData(hash, (byte *)&tinttabs[i].colors, sizeof(tinttabs[i].colors));
+    }
+    return hash;
+}
+
+static dboolean LoadTintTables(byte *tables, uint32_t hash)
+{
+    FILE                    *file = fopen(TINTTABCACHE, "rb");
+    tinttabcacheheader_t    header;
+    dboolean                result = false;
+
+    if (!file)
+        return false;
+
+    if (fread(&header, sizeof(header), 1, file) == 1
+        && !memcmp(header.id, TINTTABCACHEID, sizeof(header.id))
+        && header.version == TINTTABCACHEVERSION
+        && header.hash == hash
+        && header.numtinttabs == NUMTINTTABS)
+        result = (fread(tables, 65536, NUMTINTTABS, file) == NUMTINTTABS);
+
+    fclose(file);
     return result;
 }
 
+static void SaveTintTables(byte *tables, uint32_t hash)
+{
+    FILE                    *file = fopen(TINTTABCACHE, "wb");
+    tinttabcacheheader_t    header;
+    dboolean                result;
+
+    if (!file)
+        return;
+
+    memcpy(header.id, TINTTABCACHEID, sizeof(header.id));
+    header.version = TINTTABCACHEVERSION;
+    header.hash = hash;
+    header.numtinttabs = NUMTINTTABS;
+
+    result = (fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(tables, 65536, NUMTINTTABS, file) == NUMTINTTABS);
+
+    fclose(file);
+
+    // don't leave a partly written cache behind
+    if (!result)
+        remove(TINTTABCACHE);
+}
+
 void I_InitTintTables(byte *palette)
 {
-    tinttab = GenerateTintTable(palette, ADDITIVE, general, ALL);
-
-    tinttab25 = GenerateTintTable(palette, 25, general, ALL);
-    tinttab33 = GenerateTintTable(palette, 33, general, ALL);
-    tinttab40 = GenerateTintTable(palette, 40, general, ALL);
-    tinttab50 = GenerateTintTable(palette, 50, general, ALL);
-    tinttab60 = GenerateTintTable(palette, 60, general, ALL);
-    tinttab66 = GenerateTintTable(palette, 66, general, ALL);
-    tinttab75 = GenerateTintTable(palette, 75, general, ALL);
-    tinttab80 = GenerateTintTable(palette, 80, general, ALL);
-
-    tinttabred = GenerateTintTable(palette, ADDITIVE, general, REDS);
-    tinttabredwhite1 = GenerateTintTable(palette, ADDITIVE, general, (REDS | WHITES));
-    tinttabredwhite2 = GenerateTintTable(palette, ADDITIVE, general, (REDS | WHITES | EXTRAS));
-    tinttabgreen = GenerateTintTable(palette, ADDITIVE, general, GREENS);
-    tinttabblue = GenerateTintTable(palette, ADDITIVE, general, BLUES);
-
-    tinttabred33 = GenerateTintTable(palette, 33, general, REDS);
-    tinttabredwhite50 = GenerateTintTable(palette, 50, general, (REDS | WHITES));
-    tinttabgreen33 = GenerateTintTable(palette, 33, general, GREENS);
-    tinttabblue33 = GenerateTintTable(palette, 33, general, BLUES);
+    byte        *tables = Z_Malloc(NUMTINTTABS * 65536, PU_STATIC, NULL);
+    uint32_t    hash = HashTintTables(palette);
+    size_t      i;
+
+    for (i = 0; i < NUMTINTTABS; i++)
+        *tinttabs[i].table = tables + i * 65536;
+
+    if (!LoadTintTables(tables, hash))
+    {
+        paletteindex_t  index;
+
+        I_InitPaletteIndex(&index, palette);
+
+        for (i = 0; i < NUMTINTTABS; i++)
+            GenerateTintTable(*tinttabs[i].table, &index, tinttabs[i].percent, general,
+                tinttabs[i].colors);
+
+        I_FreePaletteIndex(&index);
+
+        SaveTintTables(tables, hash);
+    }
 }
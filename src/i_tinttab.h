@@ -39,6 +39,31 @@
 #if !defined(__I_TINTTAB__)
 #define __I_TINTTAB__
 
+// Finds the nearest colors in a palette without searching all of it. The RGB color cube
+// is divided into 32x32x32 cells, and each cell keeps a list of the only palette entries
+// that can be nearest to a color in it, made the first time a color in it is looked up.
+typedef struct
+{
+    int         offset;
+    short       count;
+} palettecell_t;
+
+typedef struct
+{
+    byte            palette[256 * 3];
+    palettecell_t   *cells;
+    byte            *candidates;
+    int             numcandidates;
+    int             maxcandidates;
+} paletteindex_t;
+
+int FindNearestColor(byte *palette, int red, int green, int blue);
+
+void I_InitPaletteIndex(paletteindex_t *index, byte *palette);
+void I_FreePaletteIndex(paletteindex_t *index);
+int I_FindNearestColor(paletteindex_t *index, int red, int green, int blue);
+void I_BenchmarkNearestColor(byte *palette);
+
 void I_InitTintTables(byte *palette);
 
 #endif
@@ -647,6 +647,14 @@ void I_FinishUpdateShowFPS(void)
     SDL_RenderPresent(renderer);
 }
 
+//
+// I_FinishUpdateHeadless
+// Nothing is presented when running without a window.
+//
+static void I_FinishUpdateHeadless(void)
+{
+}
+
 //
 // I_ReadScreen
 //
@@ -1187,10 +1195,17 @@ void I_InitGraphics(void)
     keys['a'] = keys['A'] = false;
     keys['l'] = keys['L'] = false;
 
-    I_InitTintTables(doompal);
-
     I_InitGammaTables();
 
+    // When benchmarking, render into the screen buffer allocated by V_Init()
+    // and never create a window to present it in.
+    if (benchmark)
+    {
+        screenvisible = true;
+        updatefunc = I_FinishUpdateHeadless;
+        return;
+    }
+
 #if !defined(WIN32)
     if (vid_driver && strlen(vid_driver) > 0)
     {
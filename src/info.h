@@ -1501,6 +1501,9 @@ typedef enum
     NUMMOBJTYPES
 } mobjtype_t;
 
+// Defined in r_defs.h.
+typedef struct column_context_s column_context_t;
+
 typedef struct
 {
     int         doomednum;
@@ -1535,7 +1538,7 @@ typedef struct
     char        plural1[100];
     char        name2[100];
     char        plural2[100];
-    void        (*colfunc)(void);
+    void        (*colfunc)(const column_context_t *);
 } mobjinfo_t;
 
 extern mobjinfo_t       mobjinfo[NUMMOBJTYPES];
@@ -58,6 +58,7 @@ char    *configfile = PACKAGE_CONFIG;
 
 extern dboolean am_grid;
 extern dboolean am_rotatemode;
+extern dboolean buildreject;
 extern int      episode;
 extern int      expansion;
 extern float    gp_deadzone_left;
@@ -79,6 +80,7 @@ extern int      pm_walkbob;
 extern int      r_blood;
 extern int      r_bloodsplats_max;
 extern dboolean r_brightmaps;
+extern dboolean r_columnmajor;
 extern dboolean r_corpses_mirrored;
 extern dboolean r_corpses_moreblood;
 extern dboolean r_corpses_nudge;
@@ -99,6 +101,7 @@ extern dboolean r_mirroredweapons;
 extern dboolean r_playersprites;
 extern dboolean r_rockettrails;
 extern dboolean r_shadows;
+extern int      r_threads;
 extern dboolean r_translucency;
 extern int      runcount;
 extern int      s_musicvolume;
@@ -106,6 +109,7 @@ extern dboolean s_randompitch;
 extern int      s_sfxvolume;
 extern char     *s_timiditycfgpath;
 extern int      savegame;
+extern int      sightthreads;
 extern int      skilllevel;
 extern dboolean vid_capfps;
 extern int      vid_display;
@@ -120,6 +124,7 @@ extern dboolean vid_vsync;
 extern dboolean vid_widescreen;
 extern char     *vid_windowposition;
 extern char     *vid_windowsize;
+extern int      zipcachesize;
 
 extern int      gamepadleftdeadzone;
 extern int      gamepadrightdeadzone;
@@ -149,6 +154,7 @@ static default_t cvars[] =
 {
     CONFIG_VARIABLE_INT          (am_grid,              BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (am_rotatemode,        BOOLALIAS  ),
+    CONFIG_VARIABLE_INT          (buildreject,          BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (episode,              NOALIAS    ),
     CONFIG_VARIABLE_INT          (expansion,            NOALIAS    ),
     CONFIG_VARIABLE_FLOAT_PERCENT(gp_deadzone_left,     NOALIAS    ),
@@ -170,6 +176,7 @@ static default_t cvars[] =
     CONFIG_VARIABLE_INT          (r_blood,              BLOODALIAS ),
     CONFIG_VARIABLE_INT          (r_bloodsplats_max,    SPLATALIAS ),
     CONFIG_VARIABLE_INT          (r_brightmaps,         BOOLALIAS  ),
+    CONFIG_VARIABLE_INT          (r_columnmajor,        BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (r_corpses_mirrored,   BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (r_corpses_moreblood,  BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (r_corpses_nudge,      BOOLALIAS  ),
@@ -191,6 +198,7 @@ static default_t cvars[] =
     CONFIG_VARIABLE_INT          (r_rockettrails,       BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (r_screensize,         NOALIAS    ),
     CONFIG_VARIABLE_INT          (r_shadows,            BOOLALIAS  ),
+    CONFIG_VARIABLE_INT          (r_threads,            NOALIAS    ),
     CONFIG_VARIABLE_INT          (r_translucency,       BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (runcount,             NOALIAS    ),
     CONFIG_VARIABLE_INT_PERCENT  (s_musicvolume,        NOALIAS    ),
@@ -198,6 +206,7 @@ static default_t cvars[] =
     CONFIG_VARIABLE_INT_PERCENT  (s_sfxvolume,          NOALIAS    ),
     CONFIG_VARIABLE_STRING       (s_timiditycfgpath,    NOALIAS    ),
     CONFIG_VARIABLE_INT          (savegame,             NOALIAS    ),
+    CONFIG_VARIABLE_INT          (sightthreads,         NOALIAS    ),
     CONFIG_VARIABLE_INT          (skilllevel,           NOALIAS    ),
     CONFIG_VARIABLE_INT          (vid_capfps,           BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (vid_display,          NOALIAS    ),
@@ -211,7 +220,8 @@ static default_t cvars[] =
     CONFIG_VARIABLE_INT          (vid_vsync,            BOOLALIAS  ),
     CONFIG_VARIABLE_INT          (vid_widescreen,       BOOLALIAS  ),
     CONFIG_VARIABLE_OTHER        (vid_windowposition,   NOALIAS    ),
-    CONFIG_VARIABLE_OTHER        (vid_windowsize,       NOALIAS    )
+    CONFIG_VARIABLE_OTHER        (vid_windowsize,       NOALIAS    ),
+    CONFIG_VARIABLE_INT          (zipcachesize,         NOALIAS    )
 };
 
 alias_t aliases[] =
@@ -397,6 +407,81 @@ void M_SaveCVARs(void)
         vid_widescreen = false;
 }
 
+// CVARs that change what the play simulation does, either directly or by
+// changing how many random numbers it draws.
+static const char *gameplaycvars[] =
+{
+    "buildreject",
+    "r_blood",
+    "r_bloodsplats_max",
+    "r_corpses_mirrored",
+    "r_corpses_moreblood",
+    "r_corpses_nudge",
+    "r_corpses_slide",
+    "r_corpses_smearblood",
+    "r_fixmaperrors",
+    "r_floatbob",
+    "r_liquid_bob",
+    "r_mirroredweapons",
+    "r_rockettrails",
+    "s_randompitch"
+};
+
+static dboolean M_IsGameplayCVAR(const char *name)
+{
+    int i;
+
+    for (i = 0; i < arrlen(gameplaycvars); i++)
+        if (!strcasecmp(name, gameplaycvars[i]))
+            return true;
+
+    return false;
+}
+
+//
+// M_CVARsHash
+// Returns a hash of the values of the CVARs that change how the game is
+// played, so a demo can tell if it is played back with the same
+// configuration it was recorded with.
+//
+unsigned int M_CVARsHash(void)
+{
+    unsigned int        hash = 2166136261u;
+    int                 i;
+
+    for (i = 0; i < arrlen(cvars); i++)
+    {
+        byte    *value = cvars[i].location;
+        size_t  length;
+
+        if (!M_IsGameplayCVAR(cvars[i].name))
+            continue;
+
+        switch (cvars[i].type)
+        {
+            case DEFAULT_FLOAT:
+            case DEFAULT_FLOAT_PERCENT:
+                length = sizeof(float);
+                break;
+
+            case DEFAULT_STRING:
+            case DEFAULT_OTHER:
+                value = *(byte **)cvars[i].location;
+                length = strlen((char *)value);
+                break;
+
+            default:
+                length = sizeof(int);
+                break;
+        }
+
+        while (length--)
+            hash = (hash ^ *value++) * 16777619u;
+    }
+
+    return hash;
+}
+
 // Parses integer values in the configuration file
 static int ParseIntParameter(char *strparm, int set)
 {
@@ -446,6 +531,9 @@ static void M_CheckCVARs(void)
     if (r_brightmaps != false && r_brightmaps != true)
         r_brightmaps = r_brightmaps_default;
 
+    if (r_columnmajor != false && r_columnmajor != true)
+        r_columnmajor = r_columnmajor_default;
+
     if (vid_capfps != false && vid_capfps != true)
         vid_capfps = vid_capfps_default;
 
@@ -545,6 +633,9 @@ static void M_CheckCVARs(void)
     if (am_rotatemode != false && am_rotatemode != true)
         am_rotatemode = am_rotatemode_default;
 
+    if (buildreject != false && buildreject != true)
+        buildreject = buildreject_default;
+
     runcount = BETWEEN(0, runcount, runcount_max);
 
     if (strcasecmp(vid_scaledriver, vid_scaledriver_direct3d)
@@ -564,6 +655,8 @@ static void M_CheckCVARs(void)
 
     savegame = BETWEEN(0, savegame, 5);
 
+    sightthreads = BETWEEN(sightthreads_min, sightthreads, sightthreads_max);
+
     skilllevel = BETWEEN(skilllevel_min, skilllevel, skilllevel_max);
 
     sfxVolume = (BETWEEN(s_sfxvolume_min, s_sfxvolume, s_sfxvolume_max) * 15 + 50) / 100;
@@ -571,6 +664,10 @@ static void M_CheckCVARs(void)
     if (r_shadows != false && r_shadows != true)
         r_shadows = r_shadows_default;
 
+    r_threads = BETWEEN(r_threads_min, r_threads, r_threads_max);
+
+    zipcachesize = BETWEEN(zipcachesize_min, zipcachesize, zipcachesize_max);
+
     if (r_rockettrails != false && r_rockettrails != true)
         r_rockettrails = r_rockettrails_default;
 
@@ -59,6 +59,8 @@ typedef enum
 
 #define am_rotatemode_default                   true
 
+#define buildreject_default                     false
+
 #define episode_min                             0
 #define episode_default                         0
 #define episode_max                             3
@@ -85,6 +87,10 @@ typedef enum
 
 #define iwadfolder_default                      "C:\\"
 
+#define lumplookups_min                         0
+#define lumplookups_default                     0
+#define lumplookups_max                         0
+
 #define messages_default                        false
 
 #define m_acceleration_min                      0
@@ -128,6 +134,8 @@ typedef enum
 
 #define r_brightmaps_default                    true
 
+#define r_columnmajor_default                   false
+
 #define r_corpses_mirrored_default              true
 
 #define r_corpses_moreblood_default             true
@@ -174,6 +182,10 @@ typedef enum
 
 #define r_shadows_default                       true
 
+#define r_threads_min                           1
+#define r_threads_default                       1
+#define r_threads_max                           16
+
 #define r_translucency_default                  true
 
 #define runcount_min                            0
@@ -198,6 +210,10 @@ typedef enum
 #define skilllevel_default                      sk_medium
 #define skilllevel_max                          sk_nightmare
 
+#define sightthreads_min                        1
+#define sightthreads_default                    1
+#define sightthreads_max                        16
+
 #define vid_capfps_default                      false
 
 #define vid_display_min                         1
@@ -233,6 +249,10 @@ typedef enum
 
 #define vid_windowsize_default                  "640x480"
 
+#define zipcachesize_min                        0
+#define zipcachesize_default                    32
+#define zipcachesize_max                        1024
+
 #define GAMEPADAUTOMAP_DEFAULT                  GAMEPAD_BACK
 #define GAMEPADAUTOMAPCLEARMARK_DEFAULT         0
 #define GAMEPADAUTOMAPFOLLOWMODE_DEFAULT        0
@@ -334,6 +354,7 @@ extern alias_t          aliases[];
 
 void M_LoadCVARs(char *filename);
 void M_SaveCVARs(void);
+unsigned int M_CVARsHash(void);
 char *striptrailingzero(float value, int precision);
 
 #endif
\ No newline at end of file
@@ -147,7 +147,33 @@ static int      functionkey = 0;
 static dboolean usinggamepad = false;
 
 // graphic name of skulls
-char            *skullName[2] = { "M_SKULL1", "M_SKULL2" };
+static lumpref_t skulls[2] = { LUMPREF("M_SKULL1"), LUMPREF("M_SKULL2") };
+
+// lumps drawn in the menus
+static lumpref_t playpalref = LUMPREF("PLAYPAL");
+static lumpref_t loadgref = LUMPREF("M_LOADG");
+static lumpref_t saveggref = LUMPREF("M_SAVEG");
+static lumpref_t lsleftref = LUMPREF("M_LSLEFT");
+static lumpref_t lscntrref = LUMPREF("M_LSCNTR");
+static lumpref_t lsrghtref = LUMPREF("M_LSRGHT");
+static lumpref_t svolref = LUMPREF("M_SVOL");
+static lumpref_t doomref = LUMPREF("M_DOOM");
+static lumpref_t newgref = LUMPREF("M_NEWG");
+static lumpref_t skillref = LUMPREF("M_SKILL");
+static lumpref_t episodref = LUMPREF("M_EPISOD");
+static lumpref_t optttlref = LUMPREF("M_OPTTTL");
+static lumpref_t msgonref = LUMPREF("M_MSGON");
+static lumpref_t msgoffref = LUMPREF("M_MSGOFF");
+static lumpref_t gdhighref = LUMPREF("M_GDHIGH");
+static lumpref_t gdlowref = LUMPREF("M_GDLOW");
+static lumpref_t thermlref = LUMPREF("M_THERML");
+static lumpref_t thermmref = LUMPREF("M_THERMM");
+static lumpref_t thermrref = LUMPREF("M_THERMR");
+static lumpref_t thermoref = LUMPREF("M_THERMO");
+
+// the help screen, and whether it's drawn with a shadow
+static int      helplump = -1;
+static dboolean helpshadow;
 
 // current menudef
 menu_t          *currentMenu;
@@ -869,7 +895,7 @@ void M_DrawLoad(void)
 
     M_DarkBackground();
     if (M_LOADG)
-        M_DrawCenteredPatchWithShadow(23 + OFFSET, W_CacheLumpName("M_LOADG", PU_CACHE));
+        M_DrawCenteredPatchWithShadow(23 + OFFSET, W_CacheLumpRef(&loadgref, PU_CACHE));
     else
         M_DrawCenteredString(23 + OFFSET, uppercase(s_M_LOADGAME));
 
@@ -894,16 +920,16 @@ void M_DrawSaveLoadBorder(int x, int y)
     if (M_LSCNTR)
     {
         x += 3;
-        M_DrawPatchWithShadow(x, y + 11, W_CacheLumpName("M_LSLEFT", PU_CACHE));
+        M_DrawPatchWithShadow(x, y + 11, W_CacheLumpRef(&lsleftref, PU_CACHE));
 
         x += 8;
         for (i = 0; i < 24; i++)
         {
-            M_DrawPatchWithShadow(x, y + 11, W_CacheLumpName("M_LSCNTR", PU_CACHE));
+            M_DrawPatchWithShadow(x, y + 11, W_CacheLumpRef(&lscntrref, PU_CACHE));
             x += 8;
         }
 
-        M_DrawPatchWithShadow(x, y + 11, W_CacheLumpName("M_LSRGHT", PU_CACHE));
+        M_DrawPatchWithShadow(x, y + 11, W_CacheLumpRef(&lsrghtref, PU_CACHE));
     }
     else
     {
@@ -978,7 +1004,7 @@ void M_DrawSave(void)
 
     // draw menu subtitle
     if (M_SAVEG)
-        M_DrawCenteredPatchWithShadow(23 + OFFSET, W_CacheLumpName("M_SAVEG", PU_CACHE));
+        M_DrawCenteredPatchWithShadow(23 + OFFSET, W_CacheLumpRef(&saveggref, PU_CACHE));
     else
         M_DrawCenteredString(23 + OFFSET, uppercase(s_M_SAVEGAME));
 
@@ -1280,6 +1306,28 @@ void M_QuickLoad(void)
 // M_DrawReadThis
 //
 void M_DrawReadThis(void)
+{
+    if (helplump >= 0)
+    {
+        if (automapactive)
+            V_FillRect(0, 0, 0, SCREENWIDTH, SCREENHEIGHT, 245);
+        else
+        {
+            players[0].fixedcolormap = 0;
+            M_DarkBlueBackground();
+        }
+        if (helpshadow)
+            M_DrawPatchWithShadow(0, 0, W_CacheLumpNum(helplump, PU_CACHE));
+        else
+            V_DrawPatch(0, 0, 0, W_CacheLumpNum(helplump, PU_CACHE));
+    }
+}
+
+//
+// M_InitReadThis
+// Finds the lump of the help screen.
+//
+static void M_InitReadThis(void)
 {
     char        *lumpname = "HELP1";
 
@@ -1297,19 +1345,15 @@ void M_DrawReadThis(void)
     }
     if (W_CheckNumForName(lumpname) >= 0)
     {
-        if (automapactive)
-            V_FillRect(0, 0, 0, SCREENWIDTH, SCREENHEIGHT, 245);
-        else
-        {
-            players[0].fixedcolormap = 0;
-            M_DarkBlueBackground();
-        }
         if (hacx)
-            V_DrawPatch(0, 0, 0, W_CacheLumpNum(W_GetNumForNameX("HELP", 1), PU_CACHE));
+            helplump = W_GetNumForNameX("HELP", 1);
         else if (W_CheckMultipleLumps(lumpname) > 2)
-            V_DrawPatch(0, 0, 0, W_CacheLumpNum(W_GetNumForNameX(lumpname, 2), PU_CACHE));
+            helplump = W_GetNumForNameX(lumpname, 2);
         else
-            M_DrawPatchWithShadow(0, 0, W_CacheLumpName(lumpname, PU_CACHE));
+        {
+            helplump = W_GetNumForName(lumpname);
+            helpshadow = true;
+        }
     }
 }
 
@@ -1321,7 +1365,7 @@ void M_DrawSound(void)
     M_DarkBackground();
     if (M_SVOL)
     {
-        M_DrawPatchWithShadow((chex ? 100 : 60), 38 + OFFSET, W_CacheLumpName("M_SVOL", PU_CACHE));
+        M_DrawPatchWithShadow((chex ? 100 : 60), 38 + OFFSET, W_CacheLumpRef(&svolref, PU_CACHE));
         SoundDef.x = (chex ? 68 : 80);
         SoundDef.y = 64;
     }
@@ -1405,7 +1449,7 @@ void M_MusicVol(int choice)
 //
 void M_DrawMainMenu(void)
 {
-    patch_t     *patch = W_CacheLumpName("M_DOOM", PU_CACHE);
+    patch_t     *patch = W_CacheLumpRef(&doomref, PU_CACHE);
 
     M_DarkBackground();
 
@@ -1439,7 +1483,7 @@ void M_DrawNewGame(void)
 
     if (M_NEWG)
     {
-        M_DrawPatchWithShadow((chex ? 118 : 96), 14 + OFFSET, W_CacheLumpName("M_NEWG", PU_CACHE));
+        M_DrawPatchWithShadow((chex ? 118 : 96), 14 + OFFSET, W_CacheLumpRef(&newgref, PU_CACHE));
         NewDef.x = (chex ? 98 : 48);
         NewDef.y = 63;
     }
@@ -1448,7 +1492,7 @@ void M_DrawNewGame(void)
 
     if (M_SKILL)
     {
-        M_DrawPatchWithShadow((chex ? 76 : 54), 38 + OFFSET, W_CacheLumpName("M_SKILL", PU_CACHE));
+        M_DrawPatchWithShadow((chex ? 76 : 54), 38 + OFFSET, W_CacheLumpRef(&skillref, PU_CACHE));
         NewDef.x = (chex ? 98 : 48);
         NewDef.y = 63;
     }
@@ -1475,7 +1519,7 @@ void M_DrawEpisode(void)
 
     if (M_NEWG)
     {
-        M_DrawPatchWithShadow(96, 14 + OFFSET, W_CacheLumpName("M_NEWG", PU_CACHE));
+        M_DrawPatchWithShadow(96, 14 + OFFSET, W_CacheLumpRef(&newgref, PU_CACHE));
         EpiDef.x = 48;
         EpiDef.y = 63;
     }
@@ -1484,7 +1528,7 @@ void M_DrawEpisode(void)
 
     if (M_EPISOD)
     {
-        M_DrawPatchWithShadow(54, 38 + OFFSET, W_CacheLumpName("M_EPISOD", PU_CACHE));
+        M_DrawPatchWithShadow(54, 38 + OFFSET, W_CacheLumpRef(&episodref, PU_CACHE));
         EpiDef.x = 48;
         EpiDef.y = 63;
     }
@@ -1594,7 +1638,7 @@ void M_DrawOptions(void)
     if (M_OPTTTL)
     {
         M_DrawPatchWithShadow((chex ? 126 : 108), 15 + OFFSET,
-            W_CacheLumpName("M_OPTTTL", PU_CACHE));
+            W_CacheLumpRef(&optttlref, PU_CACHE));
         OptionsDef.x = (chex ? 69 : 60);
         OptionsDef.y = 37;
     }
@@ -1605,7 +1649,7 @@ void M_DrawOptions(void)
     {
         if (M_MSGON)
             M_DrawPatchWithShadow(OptionsDef.x + 125, OptionsDef.y + 16 * msgs + OFFSET,
-                W_CacheLumpName("M_MSGON", PU_CACHE));
+                W_CacheLumpRef(&msgonref, PU_CACHE));
         else
             M_DrawString(OptionsDef.x + 125, OptionsDef.y + 16 * msgs + OFFSET, s_M_ON);
     }
@@ -1613,7 +1657,7 @@ void M_DrawOptions(void)
     {
         if (M_MSGOFF)
             M_DrawPatchWithShadow(OptionsDef.x + 125, OptionsDef.y + 16 * msgs + OFFSET,
-                W_CacheLumpName("M_MSGOFF", PU_CACHE));
+                W_CacheLumpRef(&msgoffref, PU_CACHE));
         else
             M_DrawString(OptionsDef.x + 125, OptionsDef.y + 16 * msgs + OFFSET, s_M_OFF);
     }
@@ -1622,7 +1666,7 @@ void M_DrawOptions(void)
     {
         if (M_GDHIGH)
             M_DrawPatchWithShadow(OptionsDef.x + 180, OptionsDef.y + 16 * detail + OFFSET,
-                W_CacheLumpName("M_GDHIGH", PU_CACHE));
+                W_CacheLumpRef(&gdhighref, PU_CACHE));
         else
             M_DrawString(OptionsDef.x + 177, OptionsDef.y + 16 * detail + OFFSET, s_M_HIGH);
     }
@@ -1630,7 +1674,7 @@ void M_DrawOptions(void)
     {
         if (M_GDLOW)
             M_DrawPatchWithShadow(OptionsDef.x + 180, OptionsDef.y + 16 * detail + OFFSET,
-                W_CacheLumpName("M_GDLOW", PU_CACHE));
+                W_CacheLumpRef(&gdlowref, PU_CACHE));
         else
             M_DrawString(OptionsDef.x + 177, OptionsDef.y + 16 * detail + OFFSET, s_M_LOW);
     }
@@ -2021,17 +2065,17 @@ void M_DrawThermo(int x, int y, int thermWidth, float thermDot, float factor)
         y -= 2;
     }
     xx = x;
-    M_DrawPatchWithShadow(xx, y, W_CacheLumpName("M_THERML", PU_CACHE));
+    M_DrawPatchWithShadow(xx, y, W_CacheLumpRef(&thermlref, PU_CACHE));
     xx += 8;
     for (i = 0; i < thermWidth; ++i)
     {
-        V_DrawPatch(xx, y, 0, W_CacheLumpName("M_THERMM", PU_CACHE));
+        V_DrawPatch(xx, y, 0, W_CacheLumpRef(&thermmref, PU_CACHE));
         xx += 8;
     }
-    M_DrawPatchWithShadow(xx, y, W_CacheLumpName("M_THERMR", PU_CACHE));
+    M_DrawPatchWithShadow(xx, y, W_CacheLumpRef(&thermrref, PU_CACHE));
     for (i = x + 9; i < x + (thermWidth + 1) * 8 + 1; ++i)
         V_DrawPixel(i - hacx, y + (hacx ? 9 : 13), 251, true);
-    V_DrawPatch(x + 8 + (int)(thermDot * factor), y, 0, W_CacheLumpName("M_THERMO", PU_CACHE));
+    V_DrawPatch(x + 8 + (int)(thermDot * factor), y, 0, W_CacheLumpRef(&thermoref, PU_CACHE));
 }
 
 void M_StartMessage(char *string, void *routine, dboolean input)
@@ -2230,7 +2274,7 @@ void M_ChangeGamma(dboolean shift)
     message_dontpause = true;
     message_dontfuckwithme = true;
 
-    I_SetPalette((byte *)W_CacheLumpName("PLAYPAL", PU_CACHE) + st_palette * 768);
+    I_SetPalette((byte *)W_CacheLumpRef(&playpalref, PU_CACHE) + st_palette * 768);
     M_SaveCVARs();
 }
 
@@ -3124,7 +3168,7 @@ void M_StartControlPanel(void)
     }
 
     players[0].fixedcolormap = 0;
-    I_SetPalette(W_CacheLumpName("PLAYPAL", PU_CACHE));
+    I_SetPalette(W_CacheLumpRef(&playpalref, PU_CACHE));
 }
 
 //
@@ -3211,21 +3255,22 @@ void M_Drawer(void)
     for (i = 0; i < max; ++i)
     {
         char    *name = currentMenu->menuitems[i].name;
+        int     lump = currentMenu->menuitems[i].lump;
 
         if (name[0])
         {
             if (!strcmp(name, "M_NMARE"))
             {
                 if (M_NMARE)
-                    M_DrawPatchWithShadow(x, y + OFFSET, W_CacheLumpName(name, PU_CACHE));
+                    M_DrawPatchWithShadow(x, y + OFFSET, W_CacheLumpNum(lump, PU_CACHE));
                 else
                     M_DrawNightmare();
             }
             else if (!strcmp(name, "M_MSENS") && !M_MSENS)
                 M_DrawString(x, y + OFFSET,
                     (usinggamepad ? s_M_GAMEPADSENSITIVITY : s_M_MOUSESENSITIVITY));
-            else if (W_CheckMultipleLumps(name) > 1)
-                M_DrawPatchWithShadow(x, y + OFFSET, W_CacheLumpName(name, PU_CACHE));
+            else if (lump >= 0)
+                M_DrawPatchWithShadow(x, y + OFFSET, W_CacheLumpNum(lump, PU_CACHE));
             else
                 M_DrawString(x, y + OFFSET, *currentMenu->menuitems[i].text);
         }
@@ -3235,7 +3280,7 @@ void M_Drawer(void)
     // DRAW SKULL
     if (currentMenu == &LoadDef || currentMenu == &SaveDef)
     {
-        patch_t *patch = W_CacheLumpName(skullName[whichSkull], PU_CACHE);
+        patch_t *patch = W_CacheLumpRef(&skulls[whichSkull], PU_CACHE);
 
         if (currentMenu == &LoadDef)
         {
@@ -3257,7 +3302,7 @@ void M_Drawer(void)
     }
     else if (currentMenu != &ReadDef)
     {
-        patch_t *patch = W_CacheLumpName(skullName[whichSkull], PU_CACHE);
+        patch_t *patch = W_CacheLumpRef(&skulls[whichSkull], PU_CACHE);
 
         if (currentMenu == &OptionsDef && !itemOn && !usergame)
             ++itemOn;
@@ -3281,7 +3326,7 @@ void M_ClearMenus(void)
         XInputVibration(idlemotorspeed);
     }
 
-    I_SetPalette((byte *)W_CacheLumpName("PLAYPAL", PU_CACHE) + st_palette * 768);
+    I_SetPalette((byte *)W_CacheLumpRef(&playpalref, PU_CACHE) + st_palette * 768);
 }
 
 //
@@ -3308,6 +3353,24 @@ void M_Ticker(void)
     }
 }
 
+//
+// M_InitMenuLumps
+// Finds the lumps of any menu item patches replaced by a PWAD, so they
+// aren't looked up by name every time the menu is drawn.
+//
+static void M_InitMenuLumps(menu_t *menu)
+{
+    int i;
+
+    for (i = 0; i < menu->numitems; ++i)
+    {
+        menuitem_t      *item = &menu->menuitems[i];
+
+        item->lump = (item->name[0] && W_CheckMultipleLumps(item->name) > 1 ?
+            W_GetNumForName(item->name) : -1);
+    }
+}
+
 //
 // M_Init
 //
@@ -3346,6 +3409,17 @@ void M_Init(void)
     SaveDef.lastOn = LoadDef.lastOn = savegame;
     M_ReadSaveStrings();
 
+    M_InitMenuLumps(&MainDef);
+    M_InitMenuLumps(&EpiDef);
+    M_InitMenuLumps(&ExpDef);
+    M_InitMenuLumps(&NewDef);
+    M_InitMenuLumps(&OptionsDef);
+    M_InitMenuLumps(&ReadDef);
+    M_InitMenuLumps(&SoundDef);
+    M_InitMenuLumps(&LoadDef);
+    M_InitMenuLumps(&SaveDef);
+    M_InitReadThis();
+
     if (chex)
     {
         MainDef.x += 20;
@@ -47,6 +47,9 @@ typedef struct
     char                name[10];
     void                (*routine)(int choice);
     char                **text;
+
+    // the lump of the item's patch if a PWAD replaces it, otherwise -1
+    int                 lump;
 } menuitem_t;
 
 typedef struct menu_s
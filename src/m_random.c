@@ -36,7 +36,6 @@
 ========================================================================
 */
 
-#include <stdlib.h>
 #include <time.h>
 
 #include "m_random.h"
@@ -67,8 +66,12 @@ static const unsigned char rndtable[256] = {
     120, 163, 236, 249
 };
 
-int     rndindex = 0;
-int     prndindex = 0;
+int             rndindex = 0;
+int             prndindex = 0;
+
+// the state of M_RandomInt(), kept apart from rand() so that nothing outside
+// the play simulation, like the renderer's fuzz, can change what it returns
+unsigned int    rndseed = 0;
 
 // Which one is deterministic?
 int P_Random(void)
@@ -85,7 +88,8 @@ int M_Random(void)
 
 int M_RandomInt(int lower, int upper)
 {
-    return (rand() % (upper - lower + 1) + lower);
+    rndseed = rndseed * 1664525u + 1013904223u;
+    return ((int)((rndseed >> 8) % (unsigned int)(upper - lower + 1)) + lower);
 }
 
 void M_ClearRandom(void)
@@ -94,4 +98,11 @@ void M_ClearRandom(void)
 
     // Seed the M_Random counter from the system time
     rndindex = time(NULL) & 0xFF;
+    rndseed = (unsigned int)time(NULL);
+}
+
+void M_SeedRandom(unsigned int seed)
+{
+    rndindex = seed & 0xFF;
+    rndseed = seed;
 }
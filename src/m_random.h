@@ -46,8 +46,16 @@ int M_Random(void);
 // As M_Random, but used only by the play simulation.
 int P_Random(void);
 
+extern int          prndindex;
+extern unsigned int rndseed;
+
 void M_ClearRandom(void);
 
-int M_RandomInt(int, int);
+// Seeds M_Random and M_RandomInt so their results can be repeated.
+void M_SeedRandom(unsigned int seed);
+
+// Returns a number from lower to upper. Used by the play simulation, so it
+// doesn't use rand().
+int M_RandomInt(int lower, int upper);
 
 #endif
@@ -238,8 +238,7 @@ dboolean EV_DoCeiling(line_t *line, ceiling_e type)
 
         // new door thinker
         rtn = true;
-        ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVSPEC, 0);
-        memset(ceiling, 0, sizeof(*ceiling));
+        ceiling = P_NewThinker(tp_ceiling);
         P_AddThinker(&ceiling->thinker);
         sec->ceilingdata = ceiling;
         ceiling->thinker.function = T_MoveCeiling;
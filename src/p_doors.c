@@ -344,7 +344,7 @@ dboolean EV_DoDoor(line_t *line, vldoor_e type)
 
         // new door thinker
         rtn = true;
-        door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+        door = P_NewThinker(tp_door);
         P_AddThinker(&door->thinker);
         sec->ceilingdata = door;
 
@@ -594,7 +594,7 @@ void EV_VerticalDoor(line_t *line, mobj_t *thing)
     }
 
     // new door thinker
-    door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    door = P_NewThinker(tp_door);
     P_AddThinker(&door->thinker);
     sec->ceilingdata = door;
     door->thinker.function = T_VerticalDoor;
@@ -652,7 +652,7 @@ void EV_VerticalDoor(line_t *line, mobj_t *thing)
 //
 void P_SpawnDoorCloseIn30(sector_t *sec)
 {
-    vldoor_t    *door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    vldoor_t    *door = P_NewThinker(tp_door);
 
     P_AddThinker(&door->thinker);
 
@@ -674,7 +674,7 @@ void P_SpawnDoorCloseIn30(sector_t *sec)
 //
 void P_SpawnDoorRaiseIn5Mins(sector_t *sec)
 {
-    vldoor_t    *door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    vldoor_t    *door = P_NewThinker(tp_door);
 
     P_AddThinker(&door->thinker);
 
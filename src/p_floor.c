@@ -46,6 +46,10 @@
 
 dboolean r_liquid_bob = r_liquid_bob_default;
 
+// the number of times a floor or ceiling has been moved, so the results of
+// sight checks made before can be thrown away
+int     planemoves;
+
 fixed_t animatedliquiddiffs[64] =
 {
      6422,  6422,  6360,  6238,  6054,  5814,  5516,  5164,
@@ -60,7 +64,7 @@ fixed_t animatedliquiddiffs[64] =
 
 extern dboolean canmodify;
 
-static void T_AnimateLiquid(floormove_t *floor)
+void T_AnimateLiquid(floormove_t *floor)
 {
     sector_t    *sector = floor->sector;
 
@@ -84,8 +88,7 @@ static void P_StartAnimatedLiquid(sector_t *sector)
         if (th->function == T_AnimateLiquid && ((floormove_t *)th)->sector == sector)
             return;
 
-    floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
-    memset(floor, 0, sizeof(*floor));
+    floor = P_NewThinker(tp_floor);
     P_AddThinker(&floor->thinker);
     floor->thinker.function = T_AnimateLiquid;
     floor->sector = sector;
@@ -121,6 +124,7 @@ result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest,
     sector->oldfloorheight = sector->floorheight;
     sector->oldceilingheight = sector->ceilingheight;
     sector->oldgametic = gametic;
+    planemoves++;
 
     switch (floorOrCeiling)
     {
@@ -415,8 +419,7 @@ dboolean EV_DoFloor(line_t *line, floor_e floortype)
 
         // new floor thinker
         rtn = true;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
-        memset(floor, 0, sizeof(*floor));
+        floor = P_NewThinker(tp_floor);
         P_AddThinker(&floor->thinker);
         sec->floordata = floor;
         floor->thinker.function = T_MoveFloor;
@@ -713,8 +716,7 @@ dboolean EV_BuildStairs(line_t *line, stair_e type)
 
         // new floor thinker
         rtn = true;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
-        memset(floor, 0, sizeof(*floor));
+        floor = P_NewThinker(tp_floor);
         P_AddThinker(&floor->thinker);
         sec->floordata = floor;
         floor->thinker.function = T_MoveFloor;
@@ -782,8 +784,7 @@ dboolean EV_BuildStairs(line_t *line, stair_e type)
 
                 sec = tsec;
                 secnum = newsecnum;
-                floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
-                memset(floor, 0, sizeof(*floor));
+                floor = P_NewThinker(tp_floor);
                 P_AddThinker(&floor->thinker);
 
                 sec->floordata = floor;
@@ -833,7 +834,7 @@ dboolean EV_DoElevator(line_t *line, elevator_e elevtype)
 
         // create and initialize new elevator thinker
         rtn = true;
-        elevator = Z_Malloc(sizeof(*elevator), PU_LEVSPEC, 0);
+        elevator = P_NewThinker(tp_elevator);
         P_AddThinker(&elevator->thinker);
         sec->floordata = elevator;
         sec->ceilingdata = elevator;
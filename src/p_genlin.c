@@ -105,7 +105,7 @@ manual_floor:
 
         // new floor thinker
         rtn = true;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+        floor = P_NewThinker(tp_floor);
         P_AddThinker(&floor->thinker);
         sec->floordata = floor;
         floor->thinker.function = T_MoveFloor;
@@ -315,7 +315,7 @@ manual_ceiling:
 
         // new ceiling thinker
         rtn = true;
-        ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVSPEC, 0);
+        ceiling = P_NewThinker(tp_ceiling);
         P_AddThinker(&ceiling->thinker);
         sec->ceilingdata = ceiling;
         ceiling->thinker.function = T_MoveCeiling;
@@ -526,7 +526,7 @@ manual_lift:
 
         // Setup the plat thinker
         rtn = true;
-        plat = Z_Malloc(sizeof(*plat), PU_LEVSPEC, 0);
+        plat = P_NewThinker(tp_plat);
         P_AddThinker(&plat->thinker);
         plat->sector = sec;
         plat->sector->floordata = plat;
@@ -694,7 +694,7 @@ manual_stair:
       
         // new floor thinker
         rtn = true;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+        floor = P_NewThinker(tp_floor);
         P_AddThinker(&floor->thinker);
         sec->floordata = floor;
         floor->thinker.function = T_MoveFloor;
@@ -797,7 +797,7 @@ manual_stair:
 
                 sec = tsec;
                 secnum = newsecnum;
-                floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+                floor = P_NewThinker(tp_floor);
 
                 P_AddThinker(&floor->thinker);
 
@@ -879,7 +879,7 @@ manual_crusher:
 
         // new ceiling thinker
         rtn = true;
-        ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVSPEC, 0);
+        ceiling = P_NewThinker(tp_ceiling);
         P_AddThinker(&ceiling->thinker);
         sec->ceilingdata = ceiling;     // jff 2/22/98
         ceiling->thinker.function = T_MoveCeiling;
@@ -978,7 +978,7 @@ manual_locked:
   
         // new door thinker
         rtn = true;
-        door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+        door = P_NewThinker(tp_door);
         P_AddThinker(&door->thinker);
         sec->ceilingdata = door;        //jff 2/22/98
 
@@ -1084,7 +1084,7 @@ manual_door:
   
         // new door thinker
         rtn = true;
-        door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+        door = P_NewThinker(tp_door);
         P_AddThinker(&door->thinker);
         sec->ceilingdata = door;
 
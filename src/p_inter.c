@@ -952,7 +952,7 @@ void P_KillMobj(mobj_t *source, mobj_t *target)
     mo->momz = FRACUNIT * 5 + (P_Random() << 10);
     mo->angle = target->angle + ((P_Random() - P_Random()) << 20);
     mo->flags |= MF_DROPPED;    // special versions of items
-    if (r_mirroredweapons && (rand() & 1))
+    if (r_mirroredweapons && M_RandomInt(0, 1))
     {
         mo->flags2 |= MF2_MIRRORED;
         if (mo->shadow)
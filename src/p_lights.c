@@ -63,7 +63,7 @@ void T_FireFlicker(fireflicker_t *flick)
 //
 void P_SpawnFireFlicker(sector_t *sector)
 {
-    fireflicker_t       *flick = Z_Malloc(sizeof(*flick), PU_LEVSPEC, 0);
+    fireflicker_t       *flick = P_NewThinker(tp_fireflicker);
 
     // Note that we are resetting sector attributes.
     // Nothing special about it during gameplay.
@@ -110,7 +110,7 @@ void T_LightFlash(lightflash_t *flash)
 //
 void P_SpawnLightFlash(sector_t *sector)
 {
-    lightflash_t        *flash = Z_Malloc(sizeof(*flash), PU_LEVSPEC, 0);
+    lightflash_t        *flash = P_NewThinker(tp_lightflash);
 
     // nothing special about it during gameplay
     sector->special &= ~31;     // jff 3/14/98 clear non-generalized sector type
@@ -158,7 +158,7 @@ void T_StrobeFlash(strobe_t *flash)
 //
 void P_SpawnStrobeFlash(sector_t *sector, int fastOrSlow, int inSync)
 {
-    strobe_t    *flash = Z_Malloc(sizeof(*flash), PU_LEVSPEC, 0);
+    strobe_t    *flash = P_NewThinker(tp_strobe);
 
     P_AddThinker(&flash->thinker);
 
@@ -284,7 +284,7 @@ void T_Glow(glow_t *g)
 
 void P_SpawnGlowingLight(sector_t *sector)
 {
-    glow_t *glow = Z_Malloc(sizeof(*glow), PU_LEVSPEC, 0);
+    glow_t *glow = P_NewThinker(tp_glow);
 
     P_AddThinker(&glow->thinker);
 
@@ -128,6 +128,7 @@ int P_FindDoomedNum(unsigned int type);
 
 void P_RemoveMobj(mobj_t *th);
 void P_RemoveMobjShadow(mobj_t *th);
+void P_RemoveBloodSplat(mobj_t *splat);
 dboolean P_SetMobjState(mobj_t *mobj, statenum_t state);
 void P_MobjThinker(mobj_t *mobj);
 
@@ -221,6 +222,12 @@ dboolean P_CheckLineSide(mobj_t *actor, fixed_t x, fixed_t y);
 dboolean P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y, fixed_t z, dboolean boss);
 void P_SlideMove(mobj_t *mo);
 dboolean P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_ClearSightQueries(void);
+void P_RunSightQueries(mobj_t *playermo);
+
+extern int              sightchecks;
+extern int              sightbatchhits;
+extern int              sightcachehits;
 void P_UseLines(player_t *player);
 
 dboolean P_ChangeSector(sector_t *sector, dboolean crunch);
@@ -252,6 +259,12 @@ extern fixed_t          bmaporgx;
 extern fixed_t          bmaporgy;       // origin of block map
 extern mobj_t           **blocklinks;   // for thing chains
 
+//
+// P_REJECT
+//
+dboolean P_RejectIsEmpty(int lumpnum);
+dboolean P_BuildReject(int lumpnum, byte *reject);
+
 //
 // P_INTER
 //
@@ -655,6 +655,11 @@ void P_MobjThinker(mobj_t *mobj)
         }
     }
 
+    // the player has moved for this tic, so check the sight of the monsters
+    //  that think after it
+    if (player && mobj == player->mo)
+        P_RunSightQueries(mobj);
+
     // cycle through states,
     //  calling action functions at transitions
     if (mobj->tics != -1)
@@ -681,13 +686,11 @@ void P_MobjThinker(mobj_t *mobj)
 //
 mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
-    mobj_t      *mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
+    mobj_t      *mobj = P_NewThinker(tp_mobj);
     state_t     *st;
     mobjinfo_t  *info = &mobjinfo[type];
     sector_t    *sector;
 
-    memset(mobj, 0, sizeof(*mobj));
-
     mobj->type = type;
     mobj->info = info;
     mobj->x = x;
@@ -768,6 +771,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 //
 void P_RemoveMobj(mobj_t *mobj)
 {
+    // a shadow goes with its thing
+    if (mobj->shadow && mobj->type != MT_SHADOW)
+        P_RemoveMobjShadow(mobj);
+
     // unlink from sector and block lists
     P_UnsetThingPosition(mobj);
 
@@ -790,8 +797,10 @@ void P_RemoveMobj(mobj_t *mobj)
 
 void P_RemoveMobjShadow(mobj_t *mobj)
 {
+    mobj_t  *shadow = mobj->shadow;
+
     // unlink from sector and block lists
-    P_UnsetThingPosition(mobj->shadow);
+    P_UnsetThingPosition(shadow);
 
     // Delete all nodes on the current sector_list
     if (sector_list)
@@ -800,6 +809,8 @@ void P_RemoveMobjShadow(mobj_t *mobj)
         sector_list = NULL;
     }
 
+    // shadows aren't thinkers, so nothing else refers to it
+    P_FreeThinker(&shadow->thinker);
     mobj->shadow = NULL;
 }
 
@@ -1027,7 +1038,7 @@ void P_SpawnMapThing(mapthing_t *mthing, int index)
     }
 
     if (r_mirroredweapons && (type == SuperShotgun || (type >= Shotgun && type <= BFG9000))
-        && (rand() & 1))
+        && M_RandomInt(0, 1))
         mobj->flags2 |= MF2_MIRRORED;
 
     if (!(flags & (MF_SHOOTABLE | MF_NOBLOOD)) && mobj->blood && !chex && r_bloodsplats_max)
@@ -1057,7 +1068,7 @@ void P_SpawnPuff(fixed_t x, fixed_t y, fixed_t z, angle_t angle, dboolean sound)
 
     th->angle = angle;
 
-    th->flags2 |= (rand() & 1) * MF2_MIRRORED;
+    th->flags2 |= M_RandomInt(0, 1) * MF2_MIRRORED;
 
     // don't make punches spark on the wall
     if (attackrange == MELEERANGE)
@@ -1089,7 +1100,7 @@ void P_SpawnSmokeTrail(fixed_t x, fixed_t y, fixed_t z, angle_t angle)
 
     th->angle = angle;
 
-    th->flags2 |= (rand() & 1) * MF2_MIRRORED;
+    th->flags2 |= M_RandomInt(0, 1) * MF2_MIRRORED;
 }
 
 //
@@ -1107,17 +1118,15 @@ void P_SpawnBlood(fixed_t x, fixed_t y, fixed_t z, angle_t angle, int damage, mo
 
     for (i = (damage >> 2) + 1; i; i--)
     {
-        mobj_t      *th = Z_Malloc(sizeof(*th), PU_LEVEL, NULL);
+        mobj_t      *th = P_NewThinker(tp_mobj);
         state_t     *st;
 
-        memset(th, 0, sizeof(*th));
-
         th->type = color;
         th->info = info;
         th->x = x;
         th->y = y;
         th->flags = info->flags;
-        th->flags2 = (info->flags2 | (rand() & 1) * MF2_MIRRORED);
+        th->flags2 = (info->flags2 | M_RandomInt(0, 1) * MF2_MIRRORED);
 
         st = &states[info->spawnstate];
 
@@ -1165,15 +1174,13 @@ void P_SpawnBloodSplat(fixed_t x, fixed_t y, int blood, int maxheight, mobj_t *t
 
     if (!isliquid[floorpic] && sec->floorheight <= maxheight && floorpic != skyflatnum)
     {
-        mobj_t  *newsplat = Z_Malloc(sizeof(*newsplat), PU_LEVEL, NULL);
-
-        memset(newsplat, 0, sizeof(*newsplat));
+        mobj_t  *newsplat = P_NewThinker(tp_mobj);
 
         newsplat->type = MT_BLOODSPLAT;
         newsplat->sprite = SPR_BLD2;
-        newsplat->frame = rand() & 7;
+        newsplat->frame = M_RandomInt(0, 7);
 
-        newsplat->flags2 = (MF2_DRAWFIRST | MF2_DONOTMAP | (rand() & 1) * MF2_MIRRORED);
+        newsplat->flags2 = (MF2_DRAWFIRST | MF2_DONOTMAP | M_RandomInt(0, 1) * MF2_MIRRORED);
         if (blood == FUZZYBLOOD)
         {
             newsplat->flags = MF_FUZZ;
@@ -1204,15 +1211,13 @@ void P_SpawnBloodSplat2(fixed_t x, fixed_t y, int blood, int maxheight, mobj_t *
 
     if (!isliquid[floorpic] && sec->floorheight <= maxheight && floorpic != skyflatnum)
     {
-        mobj_t  *newsplat = Z_Malloc(sizeof(*newsplat), PU_LEVEL, NULL);
-
-        memset(newsplat, 0, sizeof(*newsplat));
+        mobj_t  *newsplat = P_NewThinker(tp_mobj);
 
         newsplat->type = MT_BLOODSPLAT;
         newsplat->sprite = SPR_BLD2;
-        newsplat->frame = rand() & 7;
+        newsplat->frame = M_RandomInt(0, 7);
 
-        newsplat->flags2 = (MF2_DRAWFIRST | MF2_DONOTMAP | (rand() & 1) * MF2_MIRRORED);
+        newsplat->flags2 = (MF2_DRAWFIRST | MF2_DONOTMAP | M_RandomInt(0, 1) * MF2_MIRRORED);
         if (blood == FUZZYBLOOD)
         {
             newsplat->flags = MF_FUZZ;
@@ -1228,12 +1233,12 @@ void P_SpawnBloodSplat2(fixed_t x, fixed_t y, int blood, int maxheight, mobj_t *
         newsplat->subsector = subsec;
         P_SetBloodSplatPosition(newsplat);
 
-        if (r_bloodsplats_total > r_bloodsplats_max)
+        if (r_bloodsplats_total >= r_bloodsplats_max)
         {
             mobj_t      *oldsplat = bloodsplats[r_bloodsplats_total % r_bloodsplats_max];
 
             if (oldsplat)
-                P_UnsetThingPosition(oldsplat);
+                P_RemoveBloodSplat(oldsplat);
         }
 
         bloodsplats[r_bloodsplats_total++ % r_bloodsplats_max] = newsplat;
@@ -1243,6 +1248,24 @@ void P_SpawnBloodSplat2(fixed_t x, fixed_t y, int blood, int maxheight, mobj_t *
     }
 }
 
+//
+// P_RemoveBloodSplat
+// Blood splats aren't thinkers, so nothing else refers to one, and it can be
+//  returned to its pool straight away.
+//
+void P_RemoveBloodSplat(mobj_t *splat)
+{
+    P_UnsetThingPosition(splat);
+
+    if (sector_list)
+    {
+        P_DelSeclist(sector_list);
+        sector_list = NULL;
+    }
+
+    P_FreeThinker(&splat->thinker);
+}
+
 void P_NullBloodSplatSpawner(fixed_t x, fixed_t y, int blood, int maxheight, mobj_t *target) {}
 
 //
@@ -1250,9 +1273,7 @@ void P_NullBloodSplatSpawner(fixed_t x, fixed_t y, int blood, int maxheight, mob
 //
 void P_SpawnShadow(mobj_t *actor)
 {
-    mobj_t      *mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
-
-    memset(mobj, 0, sizeof(*mobj));
+    mobj_t      *mobj = P_NewThinker(tp_mobj);
 
     mobj->type = MT_SHADOW;
     mobj->info = &mobjinfo[MT_SHADOW];
@@ -337,6 +337,9 @@ typedef struct mobj_s
     // If == validcount, already checked.
     int                 validcount;
 
+    // 1 + index into sightqueries of the sight check made for this tic.
+    int                 sightquery;
+
     mobjtype_t          type;
     mobjinfo_t          *info;          // &mobjinfo[mobj->type]
 
@@ -381,7 +384,7 @@ typedef struct mobj_s
     // For bobbing up and down.
     int                 floatbob;
 
-    void                (*colfunc)(void);
+    void                (*colfunc)(const column_context_t *);
     void                (*projectfunc)();
 
     // a linked list of sectors where this object appears
@@ -0,0 +1,683 @@
+/*
+========================================================================
+
+                               DOOM RETRO
+         The classic, refined DOOM source port. For Windows PC.
+
+========================================================================
+
+  Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+  Copyright (C) 2013-2015 Brad Harding.
+
+  DOOM RETRO is a fork of CHOCOLATE DOOM by Simon Howard.
+  For a complete list of credits, see the accompanying AUTHORS file.
+
+  This file is part of DOOM RETRO.
+
+  DOOM RETRO is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  DOOM RETRO is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DOOM RETRO. If not, see <http://www.gnu.org/licenses/>.
+
+  DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+  company, in the US and/or other countries and is used without
+  permission. All other trademarks are the property of their respective
+  holders. DOOM RETRO is in no way affiliated with nor endorsed by
+  id Software LLC.
+
+========================================================================
+*/
+
+#include <math.h>
+
+#include "c_console.h"
+#include "doomstat.h"
+#include "i_timer.h"
+#include "m_config.h"
+#include "m_misc.h"
+#include "p_local.h"
+#include "SDL.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+//
+// REJECT BUILDER
+// Many PWADs ship an empty or truncated REJECT lump, so P_CheckSight() has to
+//  walk the BSP for every pair of sectors. If buildreject is on, one is built
+//  instead, by following the two-sided lines out of each sector and only going
+//  on through those a straight line could pass through after the lines before
+//  it. Every floor and ceiling could move, so only one-sided lines block sight.
+//  The portals are widened slightly, so sectors are only rejected if they could
+//  never see each other. The table is saved, so it is only built once per map.
+//
+#define REJECTCACHEFOLDER       "rejects"
+#define REJECTCACHEID           "DRRJ"
+#define REJECTCACHEVERSION      1
+
+#define REJECTEPSILON           0.5
+#define REJECTWIDEN             2.0
+#define MAXREJECTDEPTH          256
+#define MAXREJECTWORK           (1 << 18)
+#define MAXREJECTTHREADS        16
+
+typedef struct
+{
+    char        id[4];
+    uint32_t    version;
+    uint32_t    hash;
+    uint32_t    numsectors;
+} rejectcacheheader_t;
+
+typedef struct
+{
+    double      x1, y1;
+    double      x2, y2;
+} rejectseg_t;
+
+// keeps the side where a * x + b * y + c >= -REJECTEPSILON
+typedef struct
+{
+    double      a, b, c;
+} rejectplane_t;
+
+typedef struct
+{
+    rejectseg_t seg;
+    int         front;
+    int         back;
+} rejectportal_t;
+
+typedef struct
+{
+    byte        *visible;       // [numsectors]
+    byte        *onstack;       // [numportals]
+    int         work;
+    dboolean    overflow;
+} rejectflow_t;
+
+dboolean                buildreject = buildreject_default;
+
+extern dboolean         canmodify;
+extern dboolean         r_fixmaperrors;
+
+static rejectportal_t   *portals;
+static int              numportals;
+static int              *sectorportals;         // portals of each sector
+static int              *firstsectorportal;     // [numsectors + 1]
+static int              *components;            // sectors joined by portals
+static byte             *rejectrows;            // visible bit per sector pair
+static int              rejectrowbytes;
+static SDL_atomic_t     nextrejectsector;
+
+// FNV-1a
+static uint32_t HashRejectData(uint32_t hash, const byte *data, size_t length)
+{
+    while (length--)
+    {
+        hash ^= *data++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//
+// HashReject
+// Hashes the lumps of the map the REJECT table is built from.
+//
+static uint32_t HashReject(int lumpnum)
+{
+    const int   maplumps[] = { ML_LINEDEFS, ML_SIDEDEFS, ML_VERTEXES, ML_SECTORS };
+    byte        fixes = (canmodify && r_fixmaperrors);
+    uint32_t    hash = HashRejectData(2166136261u, &fixes, sizeof(fixes));
+    size_t      i;
+
+    for (i = 0; i < arrlen(maplumps); i++)
+    {
+        int     lump = lumpnum + maplumps[i];
+
+        hash = HashRejectData(hash, W_CacheLumpNum(lump, PU_STATIC), W_LumpLength(lump));
+        W_ReleaseLumpNum(lump);
+    }
+    return hash;
+}
+
+static char *RejectCacheFilename(uint32_t hash)
+{
+    static char filename[64];
+
+    M_snprintf(filename, sizeof(filename), "%s" DIR_SEPARATOR_S "%08X.cache", REJECTCACHEFOLDER, hash);
+    return filename;
+}
+
+static dboolean LoadReject(byte *reject, size_t length, uint32_t hash)
+{
+    FILE                *file = fopen(RejectCacheFilename(hash), "rb");
+    rejectcacheheader_t header;
+    dboolean            result = false;
+
+    if (!file)
+        return false;
+
+    if (fread(&header, sizeof(header), 1, file) == 1
+        && !memcmp(header.id, REJECTCACHEID, sizeof(header.id))
+        && header.version == REJECTCACHEVERSION
+        && header.hash == hash
+        && header.numsectors == (uint32_t)numsectors)
+        result = (fread(reject, 1, length, file) == length);
+
+    fclose(file);
+    return result;
+}
+
+static void SaveReject(byte *reject, size_t length, uint32_t hash)
+{
+    char                *filename = RejectCacheFilename(hash);
+    FILE                *file;
+    rejectcacheheader_t header;
+    dboolean            result;
+
+    M_MakeDirectory(REJECTCACHEFOLDER);
+
+    if (!(file = fopen(filename, "wb")))
+        return;
+
+    memcpy(header.id, REJECTCACHEID, sizeof(header.id));
+    header.version = REJECTCACHEVERSION;
+    header.hash = hash;
+    header.numsectors = numsectors;
+
+    result = (fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(reject, 1, length, file) == length);
+
+    fclose(file);
+
+    // don't leave a partly written cache behind
+    if (!result)
+        remove(filename);
+}
+
+//
+// P_RejectIsEmpty
+// Returns true if the REJECT lump of the map is shorter than it should be, or
+//  doesn't reject anything.
+//
+dboolean P_RejectIsEmpty(int lumpnum)
+{
+    const size_t    required = ((size_t)numsectors * numsectors + 7) / 8;
+    size_t          i;
+
+    if ((size_t)W_LumpLength(lumpnum + ML_REJECT) < required)
+        return true;
+
+    for (i = 0; i < required; i++)
+        if (rejectmatrix[i])
+            return false;
+
+    return true;
+}
+
+//
+// P_RejectGeometryIsClosed
+// Returns false if any sector isn't closed by the lines between it and other
+//  sectors, as with unclosed sectors and self-referencing sector tricks. Sight
+//  can pass into or out of those sectors without going through a line of
+//  theirs, so no REJECT table is built for the map.
+//
+static dboolean P_RejectGeometryIsClosed(void)
+{
+    byte        *degree = calloc(numvertexes, 1);
+    byte        *hasarea = calloc(numsectors, 1);
+    dboolean    result = true;
+    int         i;
+
+    for (i = 0; i < numsubsectors; i++)
+        hasarea[subsectors[i].sector - sectors] = true;
+
+    for (i = 0; i < numsectors && result; i++)
+    {
+        sector_t    *sector = &sectors[i];
+        int         boundary = 0;
+        int         j;
+
+        for (j = 0; j < sector->linecount; j++)
+        {
+            line_t  *line = sector->lines[j];
+
+            if (line->frontsector == line->backsector)
+                continue;
+
+            degree[line->v1 - vertexes] ^= 1;
+            degree[line->v2 - vertexes] ^= 1;
+            boundary++;
+        }
+
+        if (!boundary && hasarea[i])
+            result = false;
+
+        // every vertex of a closed sector joins an even number of its lines
+        for (j = 0; j < sector->linecount; j++)
+        {
+            line_t  *line = sector->lines[j];
+
+            if (degree[line->v1 - vertexes] || degree[line->v2 - vertexes])
+                result = false;
+
+            degree[line->v1 - vertexes] = degree[line->v2 - vertexes] = 0;
+        }
+    }
+
+    free(degree);
+    free(hasarea);
+    return result;
+}
+
+//
+// P_InitRejectPortals
+// Finds the lines sight can pass through, and the sectors on either side.
+//
+static void P_InitRejectPortals(void)
+{
+    int i;
+
+    portals = malloc(numlines * sizeof(*portals));
+    numportals = 0;
+
+    for (i = 0; i < numlines; i++)
+    {
+        line_t          *line = &lines[i];
+        rejectportal_t  *portal;
+        double          dx, dy, length;
+
+        if (!(line->flags & ML_TWOSIDED) || !line->backsector)
+            continue;
+
+        portal = &portals[numportals++];
+        portal->front = line->frontsector - sectors;
+        portal->back = line->backsector - sectors;
+
+        // widen the portal a little at each end, so fixed-point rounding in
+        // P_CheckSight() can't see past it
+        dx = (double)(line->v2->x - line->v1->x) / FRACUNIT;
+        dy = (double)(line->v2->y - line->v1->y) / FRACUNIT;
+
+        if ((length = sqrt(dx * dx + dy * dy)) > 0.0)
+        {
+            dx *= REJECTWIDEN / length;
+            dy *= REJECTWIDEN / length;
+        }
+
+        portal->seg.x1 = (double)line->v1->x / FRACUNIT - dx;
+        portal->seg.y1 = (double)line->v1->y / FRACUNIT - dy;
+        portal->seg.x2 = (double)line->v2->x / FRACUNIT + dx;
+        portal->seg.y2 = (double)line->v2->y / FRACUNIT + dy;
+    }
+
+    firstsectorportal = calloc(numsectors + 1, sizeof(*firstsectorportal));
+
+    for (i = 0; i < numportals; i++)
+    {
+        firstsectorportal[portals[i].front + 1]++;
+
+        if (portals[i].back != portals[i].front)
+            firstsectorportal[portals[i].back + 1]++;
+    }
+
+    for (i = 0; i < numsectors; i++)
+        firstsectorportal[i + 1] += firstsectorportal[i];
+
+    sectorportals = malloc(MAX(1, firstsectorportal[numsectors]) * sizeof(*sectorportals));
+
+    {
+        int *count = calloc(numsectors, sizeof(*count));
+
+        for (i = 0; i < numportals; i++)
+        {
+            int front = portals[i].front;
+            int back = portals[i].back;
+
+            sectorportals[firstsectorportal[front] + count[front]++] = i;
+
+            if (back != front)
+                sectorportals[firstsectorportal[back] + count[back]++] = i;
+        }
+
+        free(count);
+    }
+
+    // sectors can only see sectors they are joined to
+    components = malloc(numsectors * sizeof(*components));
+
+    for (i = 0; i < numsectors; i++)
+        components[i] = -1;
+
+    for (i = 0; i < numsectors; i++)
+    {
+        int *stack;
+        int top = 0;
+
+        if (components[i] != -1)
+            continue;
+
+        stack = malloc(numsectors * sizeof(*stack));
+        components[i] = i;
+        stack[top++] = i;
+
+        while (top)
+        {
+            int sector = stack[--top];
+            int j;
+
+            for (j = firstsectorportal[sector]; j < firstsectorportal[sector + 1]; j++)
+            {
+                rejectportal_t  *portal = &portals[sectorportals[j]];
+                int             other = (portal->front == sector ? portal->back : portal->front);
+
+                if (components[other] == -1)
+                {
+                    components[other] = i;
+                    stack[top++] = other;
+                }
+            }
+        }
+
+        free(stack);
+    }
+}
+
+static void P_FreeRejectPortals(void)
+{
+    free(portals);
+    free(sectorportals);
+    free(firstsectorportal);
+    free(components);
+}
+
+//
+// P_RejectSide
+// Returns the signed distance of a point from the line through p1 and p2,
+//  positive to its left.
+//
+static double P_RejectSide(double x1, double y1, double x2, double y2, double x, double y)
+{
+    double  dx = x2 - x1;
+    double  dy = y2 - y1;
+    double  length = sqrt(dx * dx + dy * dy);
+
+    return (length > 0.0 ? (dx * (y - y1) - dy * (x - x1)) / length : 0.0);
+}
+
+//
+// P_ClipRejectSeg
+// Clips a segment to the side of a plane it keeps. Returns false if nothing
+//  is left.
+//
+static dboolean P_ClipRejectSeg(rejectseg_t *seg, const rejectplane_t *plane)
+{
+    double  d1 = plane->a * seg->x1 + plane->b * seg->y1 + plane->c + REJECTEPSILON;
+    double  d2 = plane->a * seg->x2 + plane->b * seg->y2 + plane->c + REJECTEPSILON;
+
+    if (d1 < 0.0 && d2 < 0.0)
+        return false;
+
+    if (d1 < 0.0)
+    {
+        double  t = d1 / (d1 - d2);
+
+        seg->x1 += (seg->x2 - seg->x1) * t;
+        seg->y1 += (seg->y2 - seg->y1) * t;
+    }
+    else if (d2 < 0.0)
+    {
+        double  t = d2 / (d2 - d1);
+
+        seg->x2 += (seg->x1 - seg->x2) * t;
+        seg->y2 += (seg->y1 - seg->y2) * t;
+    }
+
+    return true;
+}
+
+//
+// P_SetRejectPlane
+// Sets the plane through p1 and p2 that keeps the side given by sign.
+//
+static void P_SetRejectPlane(rejectplane_t *plane, double x1, double y1, double x2, double y2,
+    double sign)
+{
+    double  dx = x2 - x1;
+    double  dy = y2 - y1;
+    double  length = sqrt(dx * dx + dy * dy);
+
+    plane->a = -dy * sign / length;
+    plane->b = dx * sign / length;
+    plane->c = -(plane->a * x1 + plane->b * y1);
+}
+
+//
+// P_ClipRejectSeparators
+// Clips target to where a straight line through source and then pass could
+//  reach it, using the lines from an end of source to an end of pass that
+//  have source wholly on one side and pass wholly on the other.
+//
+static dboolean P_ClipRejectSeparators(rejectseg_t *target, const rejectseg_t *source,
+    const rejectseg_t *pass)
+{
+    const double    sx[2] = { source->x1, source->x2 };
+    const double    sy[2] = { source->y1, source->y2 };
+    const double    px[2] = { pass->x1, pass->x2 };
+    const double    py[2] = { pass->y1, pass->y2 };
+    int             i, j;
+
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < 2; j++)
+        {
+            double          dx = px[j] - sx[i];
+            double          dy = py[j] - sy[i];
+            double          sourceside, passside;
+            rejectplane_t   plane;
+
+            if (dx * dx + dy * dy < REJECTEPSILON * REJECTEPSILON)
+                continue;
+
+            sourceside = P_RejectSide(sx[i], sy[i], px[j], py[j], sx[i ^ 1], sy[i ^ 1]);
+            passside = P_RejectSide(sx[i], sy[i], px[j], py[j], px[j ^ 1], py[j ^ 1]);
+
+            // keep the side pass is on
+            if (sourceside > REJECTEPSILON && passside < -REJECTEPSILON)
+                P_SetRejectPlane(&plane, sx[i], sy[i], px[j], py[j], -1.0);
+            else if (sourceside < -REJECTEPSILON && passside > REJECTEPSILON)
+                P_SetRejectPlane(&plane, sx[i], sy[i], px[j], py[j], 1.0);
+            else
+                continue;
+
+            if (!P_ClipRejectSeg(target, &plane))
+                return false;
+        }
+
+    return true;
+}
+
+//
+// P_RejectFlow
+// Marks the sectors that can be seen through the portals of a sector, having
+//  come in through source and then pass. sourceplane and passplane keep the
+//  sides of source and pass that sight is going towards.
+//
+static void P_RejectFlow(rejectflow_t *flow, int sector, const rejectseg_t *source,
+    const rejectplane_t *sourceplane, const rejectseg_t *pass, const rejectplane_t *passplane,
+    int depth)
+{
+    int i;
+
+    for (i = firstsectorportal[sector]; i < firstsectorportal[sector + 1]; i++)
+    {
+        int             index = sectorportals[i];
+        rejectportal_t  *portal = &portals[index];
+        int             other = (portal->front == sector ? portal->back : portal->front);
+        rejectseg_t     target = portal->seg;
+        rejectplane_t   plane;
+        rejectplane_t   *targetplane = NULL;
+
+        if (flow->onstack[index])
+            continue;
+
+        if (source)
+        {
+            if (sourceplane && !P_ClipRejectSeg(&target, sourceplane))
+                continue;
+
+            if (pass != source)
+            {
+                if (passplane && !P_ClipRejectSeg(&target, passplane))
+                    continue;
+
+                if (!P_ClipRejectSeparators(&target, source, pass))
+                    continue;
+            }
+        }
+
+        if (++flow->work > MAXREJECTWORK || depth >= MAXREJECTDEPTH)
+        {
+            flow->overflow = true;
+            return;
+        }
+
+        flow->visible[other] = true;
+
+        // sight goes on towards the side of the line that other is on, unless
+        // it's on both
+        if (portal->front != portal->back)
+        {
+            P_SetRejectPlane(&plane, portal->seg.x1, portal->seg.y1, portal->seg.x2,
+                portal->seg.y2, (other == portal->back ? 1.0 : -1.0));
+            targetplane = &plane;
+        }
+
+        flow->onstack[index] = true;
+        P_RejectFlow(flow, other, (source ? source : &target), (source ? sourceplane : targetplane),
+            &target, targetplane, depth + 1);
+        flow->onstack[index] = false;
+
+        if (flow->overflow)
+            return;
+    }
+}
+
+//
+// P_RejectThread
+// Takes sectors one at a time and works out which sectors they can see.
+//
+static int P_RejectThread(void *data)
+{
+    rejectflow_t    flow;
+    int             sector;
+
+    flow.visible = malloc(numsectors);
+    flow.onstack = calloc(MAX(1, numportals), 1);
+
+    while ((sector = SDL_AtomicAdd(&nextrejectsector, 1)) < numsectors)
+    {
+        byte    *row = rejectrows + (size_t)sector * rejectrowbytes;
+        int     i;
+
+        memset(flow.visible, 0, numsectors);
+        flow.visible[sector] = true;
+        flow.work = 0;
+        flow.overflow = false;
+
+        P_RejectFlow(&flow, sector, NULL, NULL, NULL, NULL, 0);
+
+        for (i = 0; i < numsectors; i++)
+            if (flow.overflow ? components[i] == components[sector] : flow.visible[i])
+                row[i >> 3] |= (1 << (i & 7));
+    }
+
+    free(flow.visible);
+    free(flow.onstack);
+    return 0;
+}
+
+//
+// P_BuildReject
+// Fills reject, which is (numsectors * numsectors + 7) / 8 bytes, with a
+//  REJECT table for the map at lumpnum, loading it from the cache if it was
+//  built before. Returns false if one can't be built for the map.
+//
+dboolean P_BuildReject(int lumpnum, byte *reject)
+{
+    const size_t    length = ((size_t)numsectors * numsectors + 7) / 8;
+    const uint32_t  hash = HashReject(lumpnum);
+    SDL_Thread      *threads[MAXREJECTTHREADS];
+    int             numthreads;
+    int             starttime;
+    int             i, j;
+
+    if (LoadReject(reject, length, hash))
+    {
+        C_Output("Loaded the REJECT table built for this map from " REJECTCACHEFOLDER
+            DIR_SEPARATOR_S "%08X.cache.", hash);
+        return true;
+    }
+
+    if (!P_RejectGeometryIsClosed())
+    {
+        C_Warning("A REJECT table can't be built for this map because not all of its sectors are closed.");
+        return false;
+    }
+
+    starttime = I_GetTimeMS();
+
+    P_InitRejectPortals();
+    rejectrowbytes = (numsectors + 7) / 8;
+    rejectrows = calloc((size_t)numsectors * rejectrowbytes, 1);
+    SDL_AtomicSet(&nextrejectsector, 0);
+
+    // the main thread is the first thread
+    numthreads = BETWEEN(1, SDL_GetCPUCount(), MAXREJECTTHREADS);
+
+    for (i = 1; i < numthreads; i++)
+        if (!(threads[i] = SDL_CreateThread(P_RejectThread, "P_Reject", NULL)))
+        {
+            numthreads = i;
+            break;
+        }
+
+    P_RejectThread(NULL);
+
+    for (i = 1; i < numthreads; i++)
+        SDL_WaitThread(threads[i], NULL);
+
+    // reject a pair of sectors only if neither can see the other
+    memset(reject, 0, length);
+
+    for (i = 0; i < numsectors; i++)
+    {
+        const byte  *row = rejectrows + (size_t)i * rejectrowbytes;
+
+        for (j = 0; j < numsectors; j++)
+            if (!(row[j >> 3] & (1 << (j & 7)))
+                && !(rejectrows[(size_t)j * rejectrowbytes + (i >> 3)] & (1 << (i & 7))))
+            {
+                size_t  pnum = (size_t)i * numsectors + j;
+
+                reject[pnum >> 3] |= (1 << (pnum & 7));
+            }
+    }
+
+    free(rejectrows);
+    P_FreeRejectPortals();
+
+    C_Output("Built a REJECT table for this map on %i thread%s in %ims.", numthreads,
+        (numthreads == 1 ? "" : "s"), I_GetTimeMS() - starttime);
+
+    SaveReject(reject, length, hash);
+    return true;
+}
@@ -1828,7 +1828,7 @@ void P_UnArchiveThinkers(void)
             P_RemoveThinkerDelayed(currentthinker);     // fix mobj leak
         }
         else
-            Z_Free(currentthinker);
+            P_FreeThinker(currentthinker);
 
         currentthinker = next;
     }
@@ -1842,11 +1842,14 @@ void P_UnArchiveThinkers(void)
 
         while (mo)
         {
-            P_RemoveMobj(mo);
-            mo = mo->snext;
+            mobj_t  *next = mo->snext;
+
+            P_RemoveBloodSplat(mo);
+            mo = next;
         }
     }
     r_bloodsplats_total = 0;
+    memset(bloodsplats, 0, sizeof(mobj_t *) * r_bloodsplats_max);
 
     // read in saved thinkers
     while (1)
@@ -1861,7 +1864,7 @@ void P_UnArchiveThinkers(void)
 
             case tc_mobj:
                 saveg_read_pad();
-                mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
+                mobj = P_NewThinker(tp_mobj);
                 saveg_read_mobj_t(mobj);
 
                 P_SetThingPosition(mobj);
@@ -1883,7 +1886,7 @@ void P_UnArchiveThinkers(void)
 
             case tc_bloodsplat:
                 saveg_read_pad();
-                mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
+                mobj = P_NewThinker(tp_mobj);
                 saveg_read_mobj_t(mobj);
 
                 P_SetThingPosition(mobj);
@@ -1900,12 +1903,12 @@ void P_UnArchiveThinkers(void)
 
                 if (r_bloodsplats_max < unlimited)
                 {
-                    if (r_bloodsplats_total > r_bloodsplats_max)
+                    if (r_bloodsplats_total >= r_bloodsplats_max)
                     {
                         mobj_t      *oldsplat = bloodsplats[r_bloodsplats_total % r_bloodsplats_max];
 
                         if (oldsplat)
-                            P_UnsetThingPosition(oldsplat);
+                            P_RemoveBloodSplat(oldsplat);
                     }
 
                     bloodsplats[r_bloodsplats_total++ % r_bloodsplats_max] = mobj;
@@ -2168,7 +2171,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_ceiling:
                 saveg_read_pad();
-                ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVEL, NULL);
+                ceiling = P_NewThinker(tp_ceiling);
                 saveg_read_ceiling_t(ceiling);
                 ceiling->sector->ceilingdata = ceiling;
                 ceiling->thinker.function = T_MoveCeiling;
@@ -2178,7 +2181,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_door:
                 saveg_read_pad();
-                door = Z_Malloc(sizeof(*door), PU_LEVEL, NULL);
+                door = P_NewThinker(tp_door);
                 saveg_read_vldoor_t(door);
                 door->sector->ceilingdata = door;
                 door->thinker.function = T_VerticalDoor;
@@ -2187,7 +2190,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_floor:
                 saveg_read_pad();
-                floor = Z_Malloc(sizeof(*floor), PU_LEVEL, NULL);
+                floor = P_NewThinker(tp_floor);
                 saveg_read_floormove_t(floor);
                 floor->sector->floordata = floor;
                 floor->thinker.function = T_MoveFloor;
@@ -2196,7 +2199,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_plat:
                 saveg_read_pad();
-                plat = Z_Malloc(sizeof(*plat), PU_LEVEL, NULL);
+                plat = P_NewThinker(tp_plat);
                 saveg_read_plat_t(plat);
                 plat->sector->floordata = plat;
 
@@ -2209,7 +2212,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_flash:
                 saveg_read_pad();
-                flash = Z_Malloc(sizeof(*flash), PU_LEVEL, NULL);
+                flash = P_NewThinker(tp_lightflash);
                 saveg_read_lightflash_t(flash);
                 flash->thinker.function = T_LightFlash;
                 P_AddThinker(&flash->thinker);
@@ -2217,7 +2220,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_strobe:
                 saveg_read_pad();
-                strobe = Z_Malloc(sizeof(*strobe), PU_LEVEL, NULL);
+                strobe = P_NewThinker(tp_strobe);
                 saveg_read_strobe_t(strobe);
                 strobe->thinker.function = T_StrobeFlash;
                 P_AddThinker(&strobe->thinker);
@@ -2225,7 +2228,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_glow:
                 saveg_read_pad();
-                glow = Z_Malloc(sizeof(*glow), PU_LEVEL, NULL);
+                glow = P_NewThinker(tp_glow);
                 saveg_read_glow_t(glow);
                 glow->thinker.function = T_Glow;
                 P_AddThinker(&glow->thinker);
@@ -2233,7 +2236,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_fireflicker:
                 saveg_read_pad();
-                fireflicker = Z_Malloc(sizeof(*fireflicker), PU_LEVEL, NULL);
+                fireflicker = P_NewThinker(tp_fireflicker);
                 saveg_read_fireflicker_t(fireflicker);
                 fireflicker->thinker.function = T_FireFlicker;
                 P_AddThinker(&fireflicker->thinker);
@@ -2241,7 +2244,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_elevator:
                 saveg_read_pad();
-                elevator = Z_Malloc(sizeof(*elevator), PU_LEVEL, NULL);
+                elevator = P_NewThinker(tp_elevator);
                 saveg_read_elevator_t(elevator);
                 elevator->sector->ceilingdata = elevator;
                 elevator->thinker.function = T_MoveElevator;
@@ -2250,7 +2253,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_scroll:
                 saveg_read_pad();
-                scroll = Z_Malloc(sizeof(*scroll), PU_LEVEL, NULL);
+                scroll = P_NewThinker(tp_scroll);
                 saveg_read_scroll_t(scroll);
                 scroll->thinker.function = T_Scroll;
                 P_AddThinker(&scroll->thinker);
@@ -2258,7 +2261,7 @@ void P_UnArchiveSpecials(void)
 
             case tc_pusher:
                 saveg_read_pad();
-                pusher = Z_Malloc(sizeof(*pusher), PU_LEVEL, NULL);
+                pusher = P_NewThinker(tp_pusher);
                 saveg_read_pusher_t(pusher);
                 pusher->thinker.function = T_Pusher;
                 pusher->source = P_GetPushThing(pusher->affectee);
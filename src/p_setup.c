@@ -37,7 +37,6 @@
 */
 
 #include <math.h>
-#include <time.h>
 
 #include "c_console.h"
 #include "doomstat.h"
@@ -47,6 +46,7 @@
 #include "m_argv.h"
 #include "m_bbox.h"
 #include "m_misc.h"
+#include "m_random.h"
 #include "p_fix.h"
 #include "p_local.h"
 #include "p_tick.h"
@@ -115,6 +115,7 @@ mobj_t          **blocklinks;
 //  used as a PVS lookup as well.
 //
 static int      rejectlump = -1;        // cph - store reject lump num if cached
+static int      maplumpnum = -1;        // lump of the map last loaded
 const byte      *rejectmatrix;          // cph - const*
 
 // Maintain single and multi player starting spots.
@@ -889,11 +890,13 @@ static void P_LoadZNodes(int lump)
 void P_LoadThings(int lump)
 {
     const mapthing_t    *data = (const mapthing_t *)W_CacheLumpNum(lump, PU_STATIC);
+    const unsigned int  seed = rndseed;
     int                 i;
 
     numthings = W_LumpLength(lump) / sizeof(mapthing_t);
 
-    srand(numthings);
+    // spawn the things the same way every time the map is loaded
+    rndseed = numthings;
 
     for (i = 0; i < numthings; i++)
     {
@@ -969,7 +972,7 @@ void P_LoadThings(int lump)
             P_SpawnMapThing(&mt, i);
     }
 
-    srand((unsigned int)time(NULL));
+    rndseed = seed;
 
     W_ReleaseLumpNum(lump);
 }
@@ -1417,7 +1420,7 @@ void P_LoadBlockMap(int lump)
             blockmaplump[i] = (t == -1 ? -1l : ((int64_t)t & 0xFFFF));
         }
 
-        Z_Free(wadblockmaplump);
+        W_ReleaseLumpNum(lump);
 
         // Read the header
         bmaporgx = blockmaplump[0] << FRACBITS;
@@ -1455,6 +1458,9 @@ void RejectOverrun(int rejectlump, const byte **rejectmatrix, int totallines)
         rejectlump = -1;
     }
 }
+
+extern dboolean buildreject;
+
 //
 // P_LoadReject - load the reject table
 //
@@ -1468,6 +1474,28 @@ static void P_LoadReject(int lumpnum, int totallines)
 
     //e6y: check for overflow
     RejectOverrun(rejectlump, &rejectmatrix, totallines);
+
+    // build a REJECT table if the map doesn't have one, but not for demos,
+    // which must play back the same with or without one
+    if (buildreject && !demoplayback && !demorecording && P_RejectIsEmpty(lumpnum))
+    {
+        const size_t    required = ((size_t)numsectors * numsectors + 7) / 8;
+        byte            *reject = Z_Malloc(required, PU_LEVEL, NULL);
+
+        if (P_BuildReject(lumpnum, reject))
+        {
+            // RejectOverrun() will have already released a short lump
+            if ((size_t)W_LumpLength(rejectlump) >= required)
+                W_ReleaseLumpNum(rejectlump);
+            else
+                Z_Free((void *)rejectmatrix);
+
+            rejectlump = -1;
+            rejectmatrix = reject;
+        }
+        else
+            Z_Free(reject);
+    }
 }
 
 //
@@ -1835,6 +1863,7 @@ void P_SetupLevel(int ep, int map)
     totalkills = totalitems = totalsecret = 0;
     wminfo.partime = 0;
     players[0].killcount = players[0].secretcount = players[0].itemcount = 0;
+    sightchecks = sightbatchhits = sightcachehits = 0;
 
     // Initial height of PointOfView
     // will be set by player think.
@@ -1846,6 +1875,7 @@ void P_SetupLevel(int ep, int map)
     S_Start();
 
     Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+    P_ClearThinkerPools();
 
     if (rejectlump != -1)
     {
@@ -1867,6 +1897,23 @@ void P_SetupLevel(int ep, int map)
     else
         lumpnum = W_GetNumForName(lumpname);
 
+    // have the lumps of the map read in ahead of loading them, and let those of
+    // the previous map go
+    if (lumpnum != maplumpnum)
+    {
+        int i;
+
+        for (i = ML_THINGS; i <= ML_BLOCKMAP; i++)
+        {
+            if (maplumpnum >= 0 && maplumpnum + i < (int)numlumps)
+                W_DiscardLumpNum(maplumpnum + i);
+            if (lumpnum + i < (int)numlumps)
+                W_PrefetchLumpNum(lumpnum + i);
+        }
+
+        maplumpnum = lumpnum;
+    }
+
     mapformat = P_CheckMapFormat(lumpnum);
 
     canmodify = ((W_CheckMultipleLumps(lumpname) == 1 || gamemission == pack_nerve
@@ -36,8 +36,19 @@
 ========================================================================
 */
 
+#include "c_console.h"
+#include "doomstat.h"
 #include "m_bbox.h"
+#include "m_config.h"
 #include "p_local.h"
+#include "p_tick.h"
+#include "SDL.h"
+
+void A_Chase(mobj_t *actor);
+void A_CPosRefire(mobj_t *actor);
+void A_Look(mobj_t *actor);
+void A_SpidRefire(mobj_t *actor);
+void A_VileAttack(mobj_t *actor);
 
 //
 // P_CheckSight
@@ -52,10 +63,78 @@ typedef struct los_s
     fixed_t     topslope, bottomslope;  // slopes to top and bottom of target
     fixed_t     bbox[4];
     fixed_t     maxz, minz;             // cph - z optimisations for 2sided lines
+    dboolean    usevalidcount;          // false when checked off the main thread
+    dboolean    moving;                 // crossed a sector with a moving floor or ceiling
 } los_t;
 
 static los_t    los; // cph - made static
 
+//
+// SIGHT QUERIES
+// Once the player has moved each tic, the sight checks that the monsters
+//  thinking after it are about to make are done together on sightthreads
+//  threads. The BSP, REJECT and sector heights can't change while they run,
+//  and a thinker only uses a result if neither thing has moved since, and no
+//  floor or ceiling the check crossed could have moved either, so the game
+//  plays exactly the same.
+//
+#define MAXSIGHTTHREADS sightthreads_max
+
+typedef struct
+{
+    mobj_t      *t1, *t2;
+    fixed_t     x1, y1, z1, height1;
+    fixed_t     x2, y2, z2, height2;
+    dboolean    result;
+    dboolean    moving;
+} sightquery_t;
+
+typedef struct
+{
+    int         first;
+    SDL_sem     *start;
+    SDL_sem     *done;
+    SDL_Thread  *thread;
+} sightthread_t;
+
+int                     sightthreads = sightthreads_default;
+
+static sightquery_t     *sightqueries;
+static int              numsightqueries;
+static int              maxsightqueries;
+
+static sightthread_t    sightthreadpool[MAXSIGHTTHREADS];
+static int              numsightthreads;
+static int              sightquerystep;
+
+//
+// SIGHT CACHE
+// The result of every sight check is also kept until the end of the tic, in
+//  a slot found from the subsectors both things are in and the height between
+//  them. Another check finds it there if both things are in the same place,
+//  and no floor or ceiling has moved since.
+//
+#define SIGHTCACHEBITS  10
+#define SIGHTCACHESIZE  (1 << SIGHTCACHEBITS)
+
+typedef struct
+{
+    int         tic;
+    int         planemoves;
+    fixed_t     x1, y1, z1, height1;
+    fixed_t     x2, y2, z2, height2;
+    dboolean    result;
+} sightcacheentry_t;
+
+static sightcacheentry_t    sightcache[SIGHTCACHESIZE];
+static int                  sightcachetic = 1;
+
+// the number of calls to P_CheckSight() since the map was loaded, and how
+// many of them used a batched or cached result
+int                     sightchecks;
+int                     sightbatchhits;
+int                     sightcachehits;
+
 //
 // P_DivlineSide
 // Returns side 0 (front), 1 (back), or 2 (on).
@@ -86,12 +165,21 @@ static fixed_t P_InterceptVector2(const divline_t *v2, const divline_t *v1)
             FixedMul((v2->y - v1->y) >> 8, v1->dx), den) : 0);
 }
 
+//
+// P_SectorMoving
+// Returns true if the sector's floor or ceiling is being moved by a thinker.
+//
+static dboolean P_SectorMoving(const sector_t *sector)
+{
+    return (sector->floordata || sector->ceilingdata);
+}
+
 //
 // P_CrossSubsector
 // Returns true
 //  if strace crosses the given subsector successfully.
 //
-static dboolean P_CrossSubsector(int num)
+static dboolean P_CrossSubsector(int num, los_t *los)
 {
     seg_t       *seg;
     int         count;
@@ -114,25 +202,30 @@ static dboolean P_CrossSubsector(int num)
     {
         line_t  *line = seg->linedef;
 
-        if (line->bbox[BOXLEFT] > los.bbox[BOXRIGHT]
-            || line->bbox[BOXRIGHT] < los.bbox[BOXLEFT]
-            || line->bbox[BOXBOTTOM] > los.bbox[BOXTOP]
-            || line->bbox[BOXTOP] < los.bbox[BOXBOTTOM])
+        // already checked other side?
+        // Checking a line twice gives the same result, so threads other than
+        // the main thread, which can't share validcount, just check it again.
+        if (los->usevalidcount)
         {
+            if (line->validcount == validcount)
+                continue;
+
             line->validcount = validcount;
-            continue;
         }
 
+        if (line->bbox[BOXLEFT] > los->bbox[BOXRIGHT]
+            || line->bbox[BOXRIGHT] < los->bbox[BOXLEFT]
+            || line->bbox[BOXBOTTOM] > los->bbox[BOXTOP]
+            || line->bbox[BOXTOP] < los->bbox[BOXBOTTOM])
+            continue;
+
         v1 = line->v1;
         v2 = line->v2;
 
         // line isn't crossed?
-        if (P_DivlineSide(v1->x, v1->y, &los.strace)
-            == P_DivlineSide(v2->x, v2->y, &los.strace))
-        {
-            line->validcount = validcount;
+        if (P_DivlineSide(v1->x, v1->y, &los->strace)
+            == P_DivlineSide(v2->x, v2->y, &los->strace))
             continue;
-        }
 
         divl.x = v1->x;
         divl.y = v1->y;
@@ -140,18 +233,9 @@ static dboolean P_CrossSubsector(int num)
         divl.dy = v2->y - v1->y;
 
         // line isn't crossed?
-        if (P_DivlineSide(los.strace.x, los.strace.y, &divl)
-            == P_DivlineSide(los.t2x, los.t2y, &divl))
-        {
-            line->validcount = validcount;
+        if (P_DivlineSide(los->strace.x, los->strace.y, &divl)
+            == P_DivlineSide(los->t2x, los->t2y, &divl))
             continue;
-        }
-
-        // already checked other side?
-        if (line->validcount == validcount)
-            continue;
-
-        line->validcount = validcount;
 
         // crosses a two sided line
         front = seg->frontsector;
@@ -160,6 +244,9 @@ static dboolean P_CrossSubsector(int num)
         // cph - do what we can before forced to check intersection
         if (line->flags & ML_TWOSIDED)
         {
+            if (P_SectorMoving(front) || P_SectorMoving(back))
+                los->moving = true;
+
             // no wall to block sight with?
             if (front->floorheight == back->floorheight
                 && front->ceilingheight == back->ceilingheight)
@@ -173,12 +260,12 @@ static dboolean P_CrossSubsector(int num)
             openbottom = MAX(front->floorheight, back->floorheight);
 
             // cph - reject if does not intrude in the z-space of the possible LOS
-            if (opentop >= los.maxz && openbottom <= los.minz)
+            if (opentop >= los->maxz && openbottom <= los->minz)
                 continue;
 
             // cph - if bottom >= top or top < minz or bottom > maxz then it must be
             // solid wrt this LOS
-            if (openbottom >= opentop || opentop < los.minz || openbottom > los.maxz)
+            if (openbottom >= opentop || opentop < los->minz || openbottom > los->maxz)
                 return false;
         }
         else
@@ -186,15 +273,15 @@ static dboolean P_CrossSubsector(int num)
 
         { 
             // crosses a two sided line
-            fixed_t     frac = P_InterceptVector2(&los.strace, &divl);
+            fixed_t     frac = P_InterceptVector2(&los->strace, &divl);
 
             if (front->floorheight != back->floorheight)
-                los.bottomslope = MAX(los.bottomslope, FixedDiv(openbottom - los.sightzstart, frac));
+                los->bottomslope = MAX(los->bottomslope, FixedDiv(openbottom - los->sightzstart, frac));
 
             if (front->ceilingheight != back->ceilingheight)
-                los.topslope = MIN(los.topslope, FixedDiv(opentop - los.sightzstart, frac));
+                los->topslope = MIN(los->topslope, FixedDiv(opentop - los->sightzstart, frac));
 
-            if (los.topslope <= los.bottomslope)
+            if (los->topslope <= los->bottomslope)
                 return false;               // stop
         }
     }
@@ -208,43 +295,47 @@ static dboolean P_CrossSubsector(int num)
 // Returns true
 //  if strace crosses the given node successfully.
 //
-static dboolean P_CrossBSPNode(int bspnum)
+static dboolean P_CrossBSPNode(int bspnum, los_t *los)
 {
     while (!(bspnum & NF_SUBSECTOR))
     {
         const node_t    *bsp = nodes + bspnum;
-        int             side1 = (P_DivlineSide(los.strace.x, los.strace.y, (divline_t *)bsp) & 1);
-        int             side2 = P_DivlineSide(los.t2x, los.t2y, (divline_t *)bsp);
+        int             side1 = (P_DivlineSide(los->strace.x, los->strace.y, (divline_t *)bsp) & 1);
+        int             side2 = P_DivlineSide(los->t2x, los->t2y, (divline_t *)bsp);
 
         if (side1 == side2)
             bspnum = bsp->children[side1];              // doesn't touch the other side
         else                                            // the partition plane is crossed here
-            if (!P_CrossBSPNode(bsp->children[side1]))
+            if (!P_CrossBSPNode(bsp->children[side1], los))
                 return false;                           // cross the starting side
             else
                 bspnum = bsp->children[side1 ^ 1];      // cross the ending side
     }
-    return P_CrossSubsector((bspnum == -1 ? 0 : (bspnum & ~NF_SUBSECTOR)));
+    return P_CrossSubsector((bspnum == -1 ? 0 : (bspnum & ~NF_SUBSECTOR)), los);
 }
 
 //
-// P_CheckSight
-// Returns true
-//  if a straight line between t1 and t2 is unobstructed.
-// Uses REJECT.
+// P_CheckSightLOS
+// Does the work of P_CheckSight() using the given LOS info.
 //
-dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+static dboolean P_CheckSightLOS(const mobj_t *t1, const mobj_t *t2, los_t *los)
 {
     const sector_t      *s1 = t1->subsector->sector;
     const sector_t      *s2 = t2->subsector->sector;
     int                 pnum = (s1 - sectors) * numsectors + (s2 - sectors);
 
+    los->moving = false;
+
     // First check for trivial rejection.
     // Determine subsector entries in REJECT table.
     // Check in REJECT table.
     if (rejectmatrix[pnum >> 3] & (1 << (pnum & 7)))
         return false;
 
+    if ((s1->heightsec != -1 && P_SectorMoving(&sectors[s1->heightsec]))
+        || (s2->heightsec != -1 && P_SectorMoving(&sectors[s2->heightsec])))
+        los->moving = true;
+
     // killough 4/19/98: make fake floors and ceilings block monster view
     if ((s1->heightsec != -1 &&
         ((t1->z + t1->height <= sectors[s1->heightsec].floorheight &&
@@ -265,42 +356,281 @@ dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
 
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
+    los->sightzstart = t1->z + t1->height - (t1->height >> 2);
+    los->bottomslope = t2->z - los->sightzstart;
+    los->topslope = los->bottomslope + t2->height;
+
+    los->strace.x = t1->x;
+    los->strace.y = t1->y;
+    los->t2x = t2->x;
+    los->t2y = t2->y;
+    los->strace.dx = t2->x - t1->x;
+    los->strace.dy = t2->y - t1->y;
+
+    los->bbox[BOXRIGHT] = MAX(t1->x, t2->x);
+    los->bbox[BOXLEFT] = MIN(t1->x, t2->x);
+    los->bbox[BOXTOP] = MAX(t1->y, t2->y);
+    los->bbox[BOXBOTTOM] = MIN(t1->y, t2->y);
+
+    // cph - calculate min and max z of the potential line of sight
+    if (los->sightzstart < t2->z)
+    {
+        los->maxz = t2->z + t2->height;
+        los->minz = los->sightzstart;
+    }
+    else if (los->sightzstart > t2->z + t2->height)
+    {
+        los->maxz = los->sightzstart;
+        los->minz = t2->z;
+    }
+    else
+    {
+        los->maxz = t2->z + t2->height;
+        los->minz = t2->z;
+    }
+
+    // the head node is the last node output
+    return P_CrossBSPNode(numnodes - 1, los);
+}
+
+//
+// P_SightCacheSlot
+// Returns the slot in sightcache for a sight check from t1 to t2.
+//
+static sightcacheentry_t *P_SightCacheSlot(const mobj_t *t1, const mobj_t *t2)
+{
+    unsigned int    key = (unsigned int)(t1->subsector - subsectors) * 65599u
+                        + (unsigned int)(t2->subsector - subsectors);
+
+    // z band
+    key = key * 65599u + (unsigned int)((t1->z - t2->z) >> (FRACBITS + 4));
+
+    return &sightcache[(key * 2654435769u) >> (32 - SIGHTCACHEBITS)];
+}
+
+//
+// P_CheckSight
+// Returns true
+//  if a straight line between t1 and t2 is unobstructed.
+// Uses REJECT.
+//
+dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+{
+    int                 index = t1->sightquery - 1;
+    sightcacheentry_t   *entry;
+
+    sightchecks++;
+
+    // use the result worked out at the start of the tic if nothing it
+    // depended on has changed since
+    if (index >= 0 && index < numsightqueries)
+    {
+        const sightquery_t  *query = &sightqueries[index];
+
+        if (query->t1 == t1 && query->t2 == t2 && !query->moving
+            && query->x1 == t1->x && query->y1 == t1->y && query->z1 == t1->z
+            && query->height1 == t1->height
+            && query->x2 == t2->x && query->y2 == t2->y && query->z2 == t2->z
+            && query->height2 == t2->height)
+        {
+            sightbatchhits++;
+            return query->result;
+        }
+    }
+
+    entry = P_SightCacheSlot(t1, t2);
+
+    if (entry->tic == sightcachetic && entry->planemoves == planemoves
+        && entry->x1 == t1->x && entry->y1 == t1->y && entry->z1 == t1->z
+        && entry->height1 == t1->height
+        && entry->x2 == t2->x && entry->y2 == t2->y && entry->z2 == t2->z
+        && entry->height2 == t2->height)
+    {
+        sightcachehits++;
+        return entry->result;
+    }
 
     validcount++;
+    los.usevalidcount = true;
+
+    entry->tic = sightcachetic;
+    entry->planemoves = planemoves;
+    entry->x1 = t1->x;
+    entry->y1 = t1->y;
+    entry->z1 = t1->z;
+    entry->height1 = t1->height;
+    entry->x2 = t2->x;
+    entry->y2 = t2->y;
+    entry->z2 = t2->z;
+    entry->height2 = t2->height;
+
+    return (entry->result = P_CheckSightLOS(t1, t2, &los));
+}
 
-    los.sightzstart = t1->z + t1->height - (t1->height >> 2);
-    los.bottomslope = t2->z - los.sightzstart;
-    los.topslope = los.bottomslope + t2->height;
+//
+// P_RunSightQueryStrip
+// Does every sightquerystep-th sight query, starting with the first.
+//
+static void P_RunSightQueryStrip(int first)
+{
+    los_t   strip;
+    int     i;
 
-    los.strace.x = t1->x;
-    los.strace.y = t1->y;
-    los.t2x = t2->x;
-    los.t2y = t2->y;
-    los.strace.dx = t2->x - t1->x;
-    los.strace.dy = t2->y - t1->y;
+    strip.usevalidcount = false;
 
-    los.bbox[BOXRIGHT] = MAX(t1->x, t2->x);
-    los.bbox[BOXLEFT] = MIN(t1->x, t2->x);
-    los.bbox[BOXTOP] = MAX(t1->y, t2->y);
-    los.bbox[BOXBOTTOM] = MIN(t1->y, t2->y);
+    for (i = first; i < numsightqueries; i += sightquerystep)
+    {
+        sightquery_t    *query = &sightqueries[i];
 
-    // cph - calculate min and max z of the potential line of sight
-    if (los.sightzstart < t2->z)
+        query->result = P_CheckSightLOS(query->t1, query->t2, &strip);
+        query->moving = strip.moving;
+    }
+}
+
+//
+// P_SightQueryThread
+//
+static int P_SightQueryThread(void *data)
+{
+    sightthread_t   *thread = data;
+
+    while (true)
+    {
+        SDL_SemWait(thread->start);
+        P_RunSightQueryStrip(thread->first);
+        SDL_SemPost(thread->done);
+    }
+
+    return 0;
+}
+
+//
+// P_StartSightThreads
+// Create any threads needed to run sight queries on sightthreads threads that
+//  haven't been already.
+//
+static void P_StartSightThreads(void)
+{
+    int threads = BETWEEN(sightthreads_min, sightthreads, MAXSIGHTTHREADS);
+
+    // the main thread is the first thread
+    if (!numsightthreads)
+        numsightthreads = 1;
+
+    while (numsightthreads < threads)
     {
-        los.maxz = t2->z + t2->height;
-        los.minz = los.sightzstart;
+        sightthread_t   *thread = &sightthreadpool[numsightthreads];
+
+        thread->first = numsightthreads;
+        thread->start = SDL_CreateSemaphore(0);
+        thread->done = SDL_CreateSemaphore(0);
+
+        if (!thread->start || !thread->done
+            || !(thread->thread = SDL_CreateThread(P_SightQueryThread, "P_SightQuery", thread)))
+        {
+            C_Warning("Only %i threads could be created to check sight.", numsightthreads);
+            sightthreads = numsightthreads;
+            break;
+        }
+
+        numsightthreads++;
     }
-    else if (los.sightzstart > t2->z + t2->height)
+}
+
+//
+// P_AddSightQuery
+//
+static void P_AddSightQuery(mobj_t *t1, mobj_t *t2)
+{
+    sightquery_t    *query;
+
+    if (numsightqueries == maxsightqueries)
     {
-        los.maxz = los.sightzstart;
-        los.minz = t2->z;
+        maxsightqueries = (maxsightqueries ? maxsightqueries * 2 : 256);
+        sightqueries = realloc(sightqueries, maxsightqueries * sizeof(*sightqueries));
     }
-    else
+
+    query = &sightqueries[numsightqueries++];
+    query->t1 = t1;
+    query->t2 = t2;
+    query->x1 = t1->x;
+    query->y1 = t1->y;
+    query->z1 = t1->z;
+    query->height1 = t1->height;
+    query->x2 = t2->x;
+    query->y2 = t2->y;
+    query->z2 = t2->z;
+    query->height2 = t2->height;
+    t1->sightquery = numsightqueries;
+}
+
+//
+// P_ChecksSight
+// Returns true if an action function checks the sight of a monster against
+//  its target, or the player if it doesn't have one.
+//
+static dboolean P_ChecksSight(actionf_t action)
+{
+    return (action == A_Chase || action == A_Look || action == A_CPosRefire
+        || action == A_SpidRefire || action == A_VileAttack);
+}
+
+//
+// P_ClearSightQueries
+// Called at the start of each tic, before the thinkers are run. Empties the
+//  sight cache, and forgets the sight queries run in the last tic.
+//
+void P_ClearSightQueries(void)
+{
+    numsightqueries = 0;
+    sightcachetic++;
+}
+
+//
+// P_RunSightQueries
+// Called by P_MobjThinker() once the player has moved. Checks the sight of
+//  every monster that thinks after the player and is about to enter a state
+//  whose action function checks sight, against its target, or the player if
+//  it doesn't have one, so that those action functions can use the results.
+//
+void P_RunSightQueries(mobj_t *playermo)
+{
+    thinker_t   *th;
+    int         threads;
+    int         i;
+
+    if (sightthreads <= 1)
+        return;
+
+    for (th = playermo->thinker.next; th != &thinkercap; th = th->next)
     {
-        los.maxz = t2->z + t2->height;
-        los.minz = t2->z;
+        mobj_t  *mo = (mobj_t *)th;
+        mobj_t  *target;
+
+        // action functions are only called as a state ends
+        if (th->function != P_MobjThinker || mo->tics != 1 || !sentient(mo) || mo->player
+            || !P_ChecksSight(states[mo->state->nextstate].action))
+            continue;
+
+        if (!(target = mo->target) || target->health <= 0)
+            target = playermo;
+
+        if (target != mo)
+            P_AddSightQuery(mo, target);
     }
 
-    // the head node is the last node output
-    return P_CrossBSPNode(numnodes - 1);
+    if (!numsightqueries)
+        return;
+
+    P_StartSightThreads();
+    threads = MIN(BETWEEN(sightthreads_min, sightthreads, MAXSIGHTTHREADS), numsightthreads);
+    sightquerystep = threads;
+
+    for (i = 1; i < threads; i++)
+        SDL_SemPost(sightthreadpool[i].start);
+
+    P_RunSightQueryStrip(0);
+
+    for (i = 1; i < threads; i++)
+        SDL_SemWait(sightthreadpool[i].done);
 }
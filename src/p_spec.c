@@ -1951,7 +1951,7 @@ dboolean EV_DoDonut(line_t *line)
             rtn = true;
 
             // Spawn rising slime
-            floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+            floor = P_NewThinker(tp_floor);
             P_AddThinker(&floor->thinker);
             s2->floordata = floor;
             floor->thinker.function = T_MoveFloor;
@@ -1966,7 +1966,7 @@ dboolean EV_DoDonut(line_t *line)
             floor->stopsound = (floor->sector->floorheight != floor->floordestheight);
 
             // Spawn lowering donut-hole
-            floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+            floor = P_NewThinker(tp_floor);
             P_AddThinker(&floor->thinker);
             s1->floordata = floor;
             floor->thinker.function = T_MoveFloor;
@@ -2234,7 +2234,7 @@ void T_Scroll(scroll_t *s)
 //
 static void Add_Scroller(int type, fixed_t dx, fixed_t dy, int control, int affectee, int accel)
 {
-    scroll_t    *s = Z_Malloc(sizeof *s, PU_LEVSPEC, 0);
+    scroll_t    *s = P_NewThinker(tp_scroll);
 
     s->thinker.function = T_Scroll;
     s->type = type;
@@ -2509,7 +2509,7 @@ static void P_SpawnFriction(void)
 // Add a push thinker to the thinker list
 static void Add_Pusher(int type, int x_mag, int y_mag, mobj_t *source, int affectee)
 {
-    pusher_t *p = Z_Malloc(sizeof *p, PU_LEVSPEC, 0);
+    pusher_t *p = P_NewThinker(tp_pusher);
 
     p->thinker.function = T_Pusher;
     p->source = source;
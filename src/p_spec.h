@@ -544,6 +544,8 @@ typedef enum
     pastdest
 } result_e;
 
+extern int      planemoves;
+
 result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, dboolean crush,
     int floorOrCeiling, int direction);
 dboolean EV_BuildStairs(line_t *line, stair_e type);
@@ -552,6 +554,7 @@ dboolean EV_DoChange(line_t *line, change_e changetype);
 dboolean EV_DoElevator(line_t *line, elevator_e elevtype);
 void T_MoveFloor(floormove_t *floor);
 void T_MoveElevator(elevator_t *elevator);
+void T_AnimateLiquid(floormove_t *floor);
 void P_InitAnimatedLiquids(void);
 
 // killough 3/7/98: Add generalized scroll effects
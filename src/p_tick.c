@@ -40,13 +40,14 @@
 #include "doomstat.h"
 #include "p_local.h"
 #include "p_tick.h"
+#include "SDL.h"
 #include "z_zone.h"
 
 int     leveltime;
 
 //
 // THINKERS
-// All thinkers should be allocated by Z_Malloc
+// All thinkers should be allocated by P_NewThinker
 // so they can be operated on uniformly.
 // The actual structures will vary in size,
 // but the first element must be thinker_t.
@@ -56,6 +57,94 @@ int     leveltime;
 // a special class of thinkers, to allow more efficient searches.
 thinker_t       thinkerclasscap[th_all + 1];
 
+#define THINKERPOOLSLAB 64
+#define CACHELINE       64
+
+thinkerpool_t   thinkerpools[NUMTHINKERPOOLS] =
+{
+    { "mobj_t",        sizeof(mobj_t)        },
+    { "ceiling_t",     sizeof(ceiling_t)     },
+    { "vldoor_t",      sizeof(vldoor_t)      },
+    { "floormove_t",   sizeof(floormove_t)   },
+    { "elevator_t",    sizeof(elevator_t)    },
+    { "plat_t",        sizeof(plat_t)        },
+    { "fireflicker_t", sizeof(fireflicker_t) },
+    { "lightflash_t",  sizeof(lightflash_t)  },
+    { "strobe_t",      sizeof(strobe_t)      },
+    { "glow_t",        sizeof(glow_t)        },
+    { "scroll_t",      sizeof(scroll_t)      },
+    { "pusher_t",      sizeof(pusher_t)      }
+};
+
+//
+// P_NewThinker
+// Returns a zeroed thing or thinker of the given type, taking it from
+//  the type's free list. If the list is empty, a slab of THINKERPOOLSLAB
+//  more, each starting on a cache line, is allocated for the level first.
+//
+void *P_NewThinker(thinkerpooltype_t type)
+{
+    thinkerpool_t       *pool = &thinkerpools[type];
+    thinker_t           *thinker;
+
+    if (!pool->freelist)
+    {
+        const size_t    size = (pool->size + CACHELINE - 1) & ~(CACHELINE - 1);
+        byte            *slab = Z_Malloc(size * THINKERPOOLSLAB + CACHELINE, PU_LEVEL, NULL);
+        byte            *object = (byte *)(((uintptr_t)slab + CACHELINE - 1) & ~(uintptr_t)(CACHELINE - 1));
+        int             i;
+
+        for (i = 0; i < THINKERPOOLSLAB; i++, object += size)
+        {
+            ((thinker_t *)object)->next = pool->freelist;
+            pool->freelist = (thinker_t *)object;
+        }
+
+        pool->pooled += THINKERPOOLSLAB;
+    }
+
+    thinker = pool->freelist;
+    pool->freelist = thinker->next;
+
+    memset(thinker, 0, pool->size);
+    thinker->pool = type;
+
+    if (++pool->live > pool->peak)
+        pool->peak = pool->live;
+
+    return thinker;
+}
+
+//
+// P_FreeThinker
+// Returns a thing or thinker to its pool.
+//
+void P_FreeThinker(thinker_t *thinker)
+{
+    thinkerpool_t       *pool = &thinkerpools[thinker->pool];
+
+    thinker->next = pool->freelist;
+    pool->freelist = thinker;
+    pool->live--;
+}
+
+//
+// P_ClearThinkerPools
+// Empties the pools once the level's memory has been freed.
+//
+void P_ClearThinkerPools(void)
+{
+    int i;
+
+    for (i = 0; i < NUMTHINKERPOOLS; i++)
+    {
+        thinkerpools[i].freelist = NULL;
+        thinkerpools[i].live = 0;
+        thinkerpools[i].peak = 0;
+        thinkerpools[i].pooled = 0;
+    }
+}
+
 //
 // P_InitThinkers
 //
@@ -149,7 +238,7 @@ void P_RemoveThinkerDelayed(thinker_t *thinker)
         // Remove from current thinker class list 
         (th->cprev = thinker->cprev)->cnext = th;
 
-        Z_Free(thinker);
+        P_FreeThinker(thinker);
     }
 }
 
@@ -190,6 +279,143 @@ void P_SetTarget(mobj_t **mop, mobj_t *targ)
         targ->thinker.references++;
 }
 
+//
+// THINKER PROFILING
+// While profiling, the time spent in each thinker function, and thinking for
+//  each type of thing, is added up over the tics run.
+//
+dboolean                thinkerprofiling;
+thinkerprofile_t        thinkerprofiles[MAXTHINKERPROFILES];
+int                     numthinkerprofiles;
+thinkerprofile_t        thingprofiles[NUMMOBJTYPES];
+int                     profiledtics;
+uint64_t                profiledtime;
+uint64_t                slowestprofiledtic;
+
+static thinkerprofile_t *lastthinkerprofile;
+
+static const thinkerprofile_t knownthinkers[] =
+{
+    { "P_MobjThinker",          P_MobjThinker          },
+    { "P_RemoveThinkerDelayed", P_RemoveThinkerDelayed },
+    { "T_AnimateLiquid",        T_AnimateLiquid        },
+    { "T_FireFlicker",          T_FireFlicker          },
+    { "T_Glow",                 T_Glow                 },
+    { "T_LightFlash",           T_LightFlash           },
+    { "T_MoveCeiling",          T_MoveCeiling          },
+    { "T_MoveElevator",         T_MoveElevator         },
+    { "T_MoveFloor",            T_MoveFloor            },
+    { "T_PlatRaise",            T_PlatRaise            },
+    { "T_Pusher",               T_Pusher               },
+    { "T_Scroll",               T_Scroll               },
+    { "T_StrobeFlash",          T_StrobeFlash          },
+    { "T_VerticalDoor",         T_VerticalDoor         }
+};
+
+//
+// P_StartThinkerProfile
+// Clears the profile and starts profiling the thinkers.
+//
+void P_StartThinkerProfile(void)
+{
+    int i;
+
+    numthinkerprofiles = arrlen(knownthinkers);
+    for (i = 0; i < numthinkerprofiles; i++)
+        thinkerprofiles[i] = knownthinkers[i];
+
+    for (i = 0; i < NUMMOBJTYPES; i++)
+    {
+        thingprofiles[i].name = mobjinfo[i].name1;
+        thingprofiles[i].function = P_MobjThinker;
+        thingprofiles[i].time = 0;
+        thingprofiles[i].calls = 0;
+    }
+
+    profiledtics = 0;
+    profiledtime = 0;
+    slowestprofiledtic = 0;
+    lastthinkerprofile = NULL;
+    thinkerprofiling = true;
+}
+
+//
+// P_StopThinkerProfile
+// Stops profiling the thinkers, keeping the profile so far.
+//
+void P_StopThinkerProfile(void)
+{
+    thinkerprofiling = false;
+}
+
+static thinkerprofile_t *P_GetThinkerProfile(think_t function)
+{
+    int i;
+
+    // consecutive thinkers often share a function
+    if (lastthinkerprofile && lastthinkerprofile->function == function)
+        return lastthinkerprofile;
+
+    for (i = 0; i < numthinkerprofiles; i++)
+        if (thinkerprofiles[i].function == function)
+            return (lastthinkerprofile = &thinkerprofiles[i]);
+
+    if (numthinkerprofiles == MAXTHINKERPROFILES)
+        return NULL;
+
+    lastthinkerprofile = &thinkerprofiles[numthinkerprofiles++];
+    lastthinkerprofile->name = "Unknown";
+    lastthinkerprofile->function = function;
+    return lastthinkerprofile;
+}
+
+//
+// P_RunThinkersProfiled
+// Same as P_RunThinkers(), but times each thinker.
+//
+static void P_RunThinkersProfiled(void)
+{
+    uint64_t    ticstart = SDL_GetPerformanceCounter();
+    uint64_t    tictime;
+
+    currentthinker = thinkercap.next;
+
+    while (currentthinker != &thinkercap)
+    {
+        think_t function = currentthinker->function;
+
+        if (function)
+        {
+            thinkerprofile_t    *profile = P_GetThinkerProfile(function);
+            thinkerprofile_t    *thingprofile = (function == P_MobjThinker ?
+                                    &thingprofiles[((mobj_t *)currentthinker)->type] : NULL);
+            uint64_t            start = SDL_GetPerformanceCounter();
+            uint64_t            time;
+
+            function(currentthinker);
+            time = SDL_GetPerformanceCounter() - start;
+
+            if (profile)
+            {
+                profile->time += time;
+                profile->calls++;
+            }
+            if (thingprofile)
+            {
+                thingprofile->time += time;
+                thingprofile->calls++;
+            }
+        }
+        currentthinker = currentthinker->next;
+    }
+
+    tictime = SDL_GetPerformanceCounter() - ticstart;
+    profiledtime += tictime;
+    if (tictime > slowestprofiledtic)
+        slowestprofiledtic = tictime;
+    profiledtics++;
+}
+
 //
 // P_RunThinkers
 //
@@ -214,6 +440,12 @@ void P_SetTarget(mobj_t **mop, mobj_t *targ)
 //
 static void P_RunThinkers(void)
 {
+    if (thinkerprofiling)
+    {
+        P_RunThinkersProfiled();
+        return;
+    }
+
     currentthinker = thinkercap.next;
 
     while (currentthinker != &thinkercap)
@@ -235,6 +467,7 @@ void P_Ticker(void)
 
     P_PlayerThink(&players[0]);
 
+    P_ClearSightQueries();
     P_RunThinkers();
     P_UpdateSpecials();
 
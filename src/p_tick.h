@@ -70,4 +70,61 @@ extern thinker_t        thinkerclasscap[];
 
 #define thinkercap      thinkerclasscap[th_all]
 
+// Things and each type of thinker are allocated from pools of their own.
+typedef enum
+{
+    tp_mobj,
+    tp_ceiling,
+    tp_door,
+    tp_floor,
+    tp_elevator,
+    tp_plat,
+    tp_fireflicker,
+    tp_lightflash,
+    tp_strobe,
+    tp_glow,
+    tp_scroll,
+    tp_pusher,
+    NUMTHINKERPOOLS
+} thinkerpooltype_t;
+
+typedef struct
+{
+    char                *name;
+    size_t              size;
+    thinker_t           *freelist;
+    int                 live;
+    int                 peak;
+    int                 pooled;
+} thinkerpool_t;
+
+extern thinkerpool_t    thinkerpools[NUMTHINKERPOOLS];
+
+void *P_NewThinker(thinkerpooltype_t type);
+void P_FreeThinker(thinker_t *thinker);
+void P_ClearThinkerPools(void);
+
+// The time spent in a thinker function, or thinking for a type of thing, while
+// the thinkers are being profiled.
+typedef struct
+{
+    char                *name;
+    think_t             function;
+    uint64_t            time;           // in performance counter ticks
+    int                 calls;
+} thinkerprofile_t;
+
+#define MAXTHINKERPROFILES      32
+
+extern dboolean         thinkerprofiling;
+extern thinkerprofile_t thinkerprofiles[MAXTHINKERPROFILES];
+extern int              numthinkerprofiles;
+extern thinkerprofile_t thingprofiles[NUMMOBJTYPES];
+extern int              profiledtics;
+extern uint64_t         profiledtime;
+extern uint64_t         slowestprofiledtic;
+
+void P_StartThinkerProfile(void);
+void P_StopThinkerProfile(void);
+
 #endif
@@ -36,6 +36,7 @@
 ========================================================================
 */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "doomstat.h"
@@ -44,17 +45,23 @@
 #include "r_plane.h"
 #include "r_things.h"
 
-seg_t           *curline;
-side_t          *sidedef;
-line_t          *linedef;
-sector_t        *frontsector;
-sector_t        *backsector;
+THREADLOCAL seg_t        *curline;
+THREADLOCAL side_t       *sidedef;
+THREADLOCAL line_t       *linedef;
+THREADLOCAL sector_t     *frontsector;
+THREADLOCAL sector_t     *backsector;
 
-dboolean        doorclosed;
+THREADLOCAL dboolean     doorclosed;
 
-drawseg_t       *drawsegs;
-unsigned int    maxdrawsegs;
-drawseg_t       *ds_p;
+THREADLOCAL drawseg_t    *drawsegs;
+THREADLOCAL unsigned int maxdrawsegs;
+THREADLOCAL drawseg_t    *ds_p;
+
+// Sectors are marked with validcount once their sprites have been added. As
+// each strip of the view walks the BSP by itself, the marks are kept here
+// rather than in sector_t.
+static THREADLOCAL int   *sectorvalidcount;
+static THREADLOCAL int   numsectorvalidcount;
 
 void R_StoreWallRange(int start, int stop);
 
@@ -64,6 +71,15 @@ void R_StoreWallRange(int start, int stop);
 void R_ClearDrawSegs(void)
 {
     ds_p = drawsegs;
+
+    // make room to mark every sector in the current map
+    if (numsectorvalidcount < numsectors)
+    {
+        sectorvalidcount = realloc(sectorvalidcount, numsectors * sizeof(*sectorvalidcount));
+        memset(sectorvalidcount + numsectorvalidcount, 0,
+            (numsectors - numsectorvalidcount) * sizeof(*sectorvalidcount));
+        numsectorvalidcount = numsectors;
+    }
 }
 
 //
@@ -96,8 +112,8 @@ typedef struct
 #define MAXSEGS (SCREENWIDTH / 2 + 1)
 
 // newend is one past the last valid seg
-static cliprange_t      *newend;
-static cliprange_t      solidsegs[MAXSEGS];
+static THREADLOCAL cliprange_t  *newend;
+static THREADLOCAL cliprange_t  solidsegs[MAXSEGS];
 
 //
 // R_ClipSolidWallSegment
@@ -228,8 +244,8 @@ static void R_ClipPassWallSegment(int first, int last)
 void R_ClearClipSegs(void)
 {
     solidsegs[0].first = INT_MIN + 1;
-    solidsegs[0].last = -1;
-    solidsegs[1].first = viewwidth;
+    solidsegs[0].last = stripx1 - 1;
+    solidsegs[1].first = stripx2 + 1;
     solidsegs[1].last = INT_MAX - 1;
     newend = solidsegs + 2;
 }
@@ -399,7 +415,7 @@ static void R_AddLine(seg_t *line)
     angle_t             angle2;
     angle_t             span;
     angle_t             tspan;
-    static sector_t     tempsec;        // killough 3/8/98: ceiling/water hack
+    static THREADLOCAL sector_t tempsec;        // killough 3/8/98: ceiling/water hack
 
     curline = line;
 
@@ -459,11 +475,6 @@ static void R_AddLine(seg_t *line)
     if (!backsector)
         goto clipsolid;
 
-    // [AM] Interpolate sector movement before
-    //      running clipping tests.  Frontsector
-    //      should already be interpolated.
-    R_MaybeInterpolateSector(backsector);
-
     // killough 3/8/98, 4/4/98: hack for invisible ceilings / deep water
     backsector = R_FakeFlat(backsector, &tempsec, NULL, NULL, true);
 
@@ -628,10 +639,6 @@ static void R_Subsector(int num)
 
     frontsector = sub->sector;
 
-    // [AM] Interpolate sector movement.  Usually only needed
-    //      when you're standing inside the sector.
-    R_MaybeInterpolateSector(frontsector);
-
     // killough 3/8/98, 4/4/98: Deep water / fake ceiling effect
     frontsector = R_FakeFlat(frontsector, &tempsec, &floorlightlevel, &ceilinglightlevel, false);
 
@@ -668,9 +675,9 @@ static void R_Subsector(int num)
     // Either you must pass the fake sector and handle validcount here, on the
     // real sector, or you must account for the lighting in some other way, 
     // like passing it as an argument.
-    if (sub->sector->validcount != validcount)
+    if (sectorvalidcount[sub->sector - sectors] != validcount)
     {
-        sub->sector->validcount = validcount;
+        sectorvalidcount[sub->sector - sectors] = validcount;
         R_AddSprites(sub->sector, (floorlightlevel + ceilinglightlevel) / 2);
     }
 
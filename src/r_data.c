@@ -38,9 +38,11 @@
 
 #include "c_console.h"
 #include "d_deh.h"
+#include "d_main.h"
 #include "doomstat.h"
 #include "i_swap.h"
 #include "i_system.h"
+#include "i_tinttab.h"
 #include "m_misc.h"
 #include "p_local.h"
 #include "p_tick.h"
@@ -48,6 +50,8 @@
 #include "w_wad.h"
 #include "z_zone.h"
 
+#include "SDL.h"
+
 //
 // Graphics.
 // DOOM graphics for walls and sprites
@@ -87,6 +91,20 @@ unsigned int    **texturecolumnofs;
 unsigned int    **texturecolumnofs2; // [crispy] original column offsets for single-patched textures
 byte            **texturecomposite;
 
+// Copies of the columns of textures whose heights aren't a power-of-2, each repeated
+// to fill a power-of-2 height, so that most wall columns can be drawn without wrapping.
+int             *texturepadheight;
+static byte     **texturepadded;
+static int      texturepaddedsize;
+
+#define MAXPADHEIGHT    1024
+
+// The textures on the sides of the current level, which have their composites
+// built on their own thread.
+static byte             *precachetextures;
+static SDL_Thread       *precachethread;
+static SDL_atomic_t     precachecancel;
+
 // for global animation
 int             *flattranslation;
 int             *texturetranslation;
@@ -273,8 +291,9 @@ void R_DrawColumnInCache(const column_t *patch, byte *cache, int originy, int ca
 //
 static void R_GenerateComposite(int texnum)
 {
-    byte                *block = Z_Malloc(texturecompositesize[texnum], PU_STATIC,
-                                          (void **)&texturecomposite[texnum]);
+    // Don't publish the composite until it has been built, as other strips of the view,
+    // or R_PrecacheTextures(), may be checking for it.
+    byte                *block = Z_Malloc(texturecompositesize[texnum], PU_STATIC, NULL);
     texture_t           *texture = textures[texnum];
 
     // Composite the columns together.
@@ -353,6 +372,39 @@ static void R_GenerateComposite(int texnum)
 
     // Now that the texture has been built in column cache,
     // it is purgable from zone memory.
+    Z_ChangeUser(block, (void **)&texturecomposite[texnum]);
+    Z_ChangeTag(block, PU_CACHE);
+}
+
+//
+// R_GeneratePaddedColumns
+// Copies each column of a texture's composite, repeated
+//  until it fills the texture's padded height.
+//
+static void R_GeneratePaddedColumns(int texnum)
+{
+    const int           padheight = texturepadheight[texnum];
+    const texture_t     *texture = textures[texnum];
+    const int           height = texture->height;
+    byte                *block = Z_Malloc(texture->width * padheight, PU_STATIC, NULL);
+    const unsigned int  *colofs = texturecolumnofs[texnum];
+    int                 x;
+
+    // The allocation above may have purged the composite.
+    if (!texturecomposite[texnum])
+        R_GenerateComposite(texnum);
+
+    for (x = 0; x < texture->width; x++)
+    {
+        const byte      *source = texturecomposite[texnum] + colofs[x];
+        byte            *dest = block + x * padheight;
+        int             y;
+
+        for (y = 0; y < padheight; y += height)
+            memcpy(dest + y, source, MIN(height, padheight - y));
+    }
+
+    Z_ChangeUser(block, (void **)&texturepadded[texnum]);
     Z_ChangeTag(block, PU_CACHE);
 }
 
@@ -477,10 +529,13 @@ static void R_GenerateLookup(int texnum)
 
 //
 // R_GetColumn
+// Composites and padded columns are checked for without the zone
+//  lock, so are read, and published by Z_ChangeUser(), atomically.
 //
 byte *R_GetColumn(int tex, int col, dboolean opaque)
 {
-    int lump;
+    int         lump;
+    byte        *block;
 
     col &= texturewidthmask[tex];
     lump = texturecolumnlump[tex][col];
@@ -489,10 +544,41 @@ byte *R_GetColumn(int tex, int col, dboolean opaque)
     if (lump > 0 && !opaque)
         return ((byte *)W_CacheLumpNum(lump, PU_CACHE) + texturecolumnofs2[tex][col]);
 
-    if (!texturecomposite[tex])
-        R_GenerateComposite(tex);
+    // walls are drawn from the padded columns, if there are any
+    if (opaque && texturepadheight[tex])
+    {
+        if (!(block = SDL_AtomicGetPtr((void **)&texturepadded[tex])))
+        {
+            Z_Lock();
 
-    return (texturecomposite[tex] + texturecolumnofs[tex][col]);
+            if (!(block = texturepadded[tex]))
+            {
+                R_GeneratePaddedColumns(tex);
+                block = texturepadded[tex];
+            }
+
+            Z_Unlock();
+        }
+
+        return (block + col * texturepadheight[tex]);
+    }
+
+    // the composite is usually built by R_PrecacheTextures() first
+    if (!(block = SDL_AtomicGetPtr((void **)&texturecomposite[tex])))
+    {
+        Z_Lock();
+
+        // check again, in case another thread generated it while waiting
+        if (!(block = texturecomposite[tex]))
+        {
+            R_GenerateComposite(tex);
+            block = texturecomposite[tex];
+        }
+
+        Z_Unlock();
+    }
+
+    return (block + texturecolumnofs[tex][col]);
 }
 
 static void GenerateTextureHashTable(void)
@@ -718,6 +804,8 @@ void R_InitTextures(void)
     texturecompositesize = Z_Malloc(numtextures * sizeof(*texturecompositesize), PU_STATIC, 0);
     texturewidthmask = Z_Malloc(numtextures * sizeof(*texturewidthmask), PU_STATIC, 0);
     textureheight = Z_Malloc(numtextures * sizeof(*textureheight), PU_STATIC, 0);
+    texturepadheight = Z_Malloc(numtextures * sizeof(*texturepadheight), PU_STATIC, 0);
+    texturepadded = Z_Malloc(numtextures * sizeof(*texturepadded), PU_STATIC, 0);
     texturefullbright = Z_Malloc(numtextures * sizeof(*texturefullbright), PU_STATIC, 0);
 
     for (i = 0; i < numtextures; ++i, ++directory)
@@ -786,11 +874,32 @@ void R_InitTextures(void)
         texturewidthmask[i] = j - 1;
         textureheight[i] = texture->height << FRACBITS;
 
+        // pad textures whose heights aren't a power-of-2 to at least twice their height
+        texturepadded[i] = NULL;
+        texturepadheight[i] = 0;
+
+        if (texture->height & (texture->height - 1))
+        {
+            j = 1;
+            while (j < texture->height * 2)
+                j <<= 1;
+
+            if (j <= MAXPADHEIGHT)
+            {
+                texturepadheight[i] = j;
+                texturepaddedsize += texture->width * j;
+            }
+        }
+
         R_DoomTextureHacks(texture);
     }
 
     Z_Free(patchlookup);
 
+    if (texturepaddedsize)
+        C_Output("Padding textures to power-of-2 heights will use up to %sKB more memory.",
+            commify(texturepaddedsize / 1024));
+
     // [crispy] release memory allocated for texture files
     for (i = 0; i < numtexturelumps; ++i)
         W_ReleaseLumpNum(texturelumps[i].lumpnum);
@@ -935,15 +1044,15 @@ void R_InitSpriteLumps(void)
 //
 // killough 4/4/98: Add support for C_START/C_END markers
 //
-extern int FindNearestColor(byte *palette, int red, int green, int blue);
-
 byte grays[256];
 
 void R_InitColormaps(void)
 {
     dboolean    COLORMAP = (W_CheckMultipleLumps("COLORMAP") > 1);
     int         i;
+    int         lump;
     byte        *palsrc, *palette;
+    paletteindex_t  index;
 
     if (W_CheckNumForName("C_START") >= 0 && W_CheckNumForName("C_END") >= 0)
     {
@@ -953,16 +1062,17 @@ void R_InitColormaps(void)
 
         colormaps = Z_Malloc(sizeof(*colormaps) * numcolormaps, PU_STATIC, 0);
 
-        colormaps[0] = W_CacheLumpNum(W_GetNumForName("COLORMAP"), PU_STATIC);
-
         for (i = 1; i < numcolormaps; i++)
             colormaps[i] = W_CacheLumpNum(i + firstcolormaplump, PU_STATIC);
     }
     else
-    {
         colormaps = Z_Malloc(sizeof(*colormaps), PU_STATIC, 0);
-        colormaps[0] = W_CacheLumpNum(W_GetNumForName("COLORMAP"), PU_STATIC);
-    }
+
+    // COLORMAP gets a copy of its own, as colormap 32 may be changed below and
+    // the lump itself may be in a read-only memory-mapped WAD
+    lump = W_GetNumForName("COLORMAP");
+    colormaps[0] = Z_Malloc(W_LumpLength(lump), PU_STATIC, NULL);
+    W_ReadLump(lump, colormaps[0]);
 
     // [BH] There's a typo in dcolors.c, the source code of the utility Id
     // Software used to construct the palettes and colormaps for DOOM (see
@@ -974,6 +1084,7 @@ void R_InitColormaps(void)
     // 32 is manually calculated rather than grabbing it from the colormap lump.
     // The resulting differences are minor.
     palsrc = palette = W_CacheLumpName("PLAYPAL", PU_CACHE);
+    I_InitPaletteIndex(&index, palette);
 
     for (i = 0; i < 255; i++)
     {
@@ -982,15 +1093,17 @@ void R_InitColormaps(void)
         float       blue = *palsrc++ / 256.0f;
         float       gray = red * 0.299f + green * 0.587f + blue * 0.114f/*0.144f*/;
 
-        grays[i] = FindNearestColor(palette, (int)(gray * 255.0f),
+        grays[i] = I_FindNearestColor(&index, (int)(gray * 255.0f),
             (int)(gray * 255.0f), (int)(gray * 255.0f));
 
         if (!COLORMAP)
         {
             gray = (1.0f - gray) * 255.0f;
-            colormaps[0][32 * 256 + i] = FindNearestColor(palette, (int)gray, (int)gray, (int)gray);
+            colormaps[0][32 * 256 + i] = I_FindNearestColor(&index, (int)gray, (int)gray, (int)gray);
         }
     }
+
+    I_FreePaletteIndex(&index);
 }
 
 // killough 4/4/98: get colormap number from name
@@ -1016,10 +1129,10 @@ int R_ColormapNumForName(char *name)
 //
 void R_InitData(void)
 {
-    R_InitTextures();
-    R_InitFlats();
-    R_InitSpriteLumps();
-    R_InitColormaps();
+    D_RunTask("R_InitTextures", R_InitTextures);
+    D_RunTask("R_InitFlats", R_InitFlats);
+    D_RunTask("R_InitSpriteLumps", R_InitSpriteLumps);
+    D_RunTask("R_InitColormaps", R_InitColormaps);
 }
 
 //
@@ -1101,6 +1214,57 @@ int R_TextureNumForName(char *name)
     return i;
 }
 
+//
+// R_PrecacheTextures
+// Builds the composites of the textures on the sides of the current level, so
+//  they aren't built while the view is rendered the first time they are seen.
+//
+static int R_PrecacheTextures(void *data)
+{
+    int i;
+
+    for (i = 0; i < numtextures && !SDL_AtomicGet(&precachecancel); i++)
+        if (precachetextures[i])
+        {
+            Z_Lock();
+
+            if (!texturecomposite[i])
+                R_GenerateComposite(i);
+
+            if (texturepadheight[i] && !texturepadded[i])
+                R_GeneratePaddedColumns(i);
+
+            Z_Unlock();
+        }
+
+    return 0;
+}
+
+//
+// R_StopPrecaching
+// Stops building the composites of the textures of the previous level.
+//
+void R_StopPrecaching(void)
+{
+    if (precachethread)
+    {
+        SDL_AtomicSet(&precachecancel, 1);
+        SDL_WaitThread(precachethread, NULL);
+        precachethread = NULL;
+    }
+}
+
+//
+// R_PrecacheLumpNum
+// Loads a lump ahead of it being drawn. If its WAD is memory-mapped, the OS
+//  is asked to read it in instead.
+//
+static void R_PrecacheLumpNum(int lumpnum)
+{
+    W_PrefetchLumpNum(lumpnum);
+    W_CacheLumpNum(lumpnum, PU_CACHE);
+}
+
 //
 // R_PrecacheLevel
 // Preloads all relevant graphics for the level.
@@ -1113,7 +1277,7 @@ void R_PrecacheLevel(void)
     int         j;
     int         k;
 
-    hitlist = malloc(MAX(numtextures, MAX(numflats, numsprites)));
+    hitlist = malloc(MAX(numflats, numsprites));
 
     // Precache flats.
     memset(hitlist, 0, numflats);
@@ -1126,16 +1290,21 @@ void R_PrecacheLevel(void)
 
     for (i = 0; i < numflats; i++)
         if (hitlist[i])
-            W_CacheLumpNum(firstflat + i, PU_CACHE);
+            R_PrecacheLumpNum(firstflat + i);
+
+    // Precache textures, building their composites on their own thread.
+    R_StopPrecaching();
 
-    // Precache textures.
-    memset(hitlist, 0, numtextures);
+    if (!precachetextures)
+        precachetextures = malloc(numtextures);
+
+    memset(precachetextures, 0, numtextures);
 
     for (i = 0; i < numsides; i++)
     {
-        hitlist[sides[i].toptexture] = 1;
-        hitlist[sides[i].midtexture] = 1;
-        hitlist[sides[i].bottomtexture] = 1;
+        precachetextures[sides[i].toptexture] = 1;
+        precachetextures[sides[i].midtexture] = 1;
+        precachetextures[sides[i].bottomtexture] = 1;
     }
 
     // Sky texture is always present.
@@ -1144,17 +1313,24 @@ void R_PrecacheLevel(void)
     //  while the sky texture is stored like
     //  a wall texture, with an episode dependend
     //  name.
-    hitlist[skytexture] = 1;
+    precachetextures[skytexture] = 1;
 
+    // the patches are read from the WAD while building the composites, so if it's
+    // mapped, have them read in now
     for (i = 0; i < numtextures; i++)
-        if (hitlist[i])
+        if (precachetextures[i])
         {
-            texture_t       *texture = textures[i];
+            texture_t   *texture = textures[i];
 
             for (j = 0; j < texture->patchcount; j++)
-                W_CacheLumpNum(texture->patches[j].patch, PU_CACHE);
+                W_PrefetchLumpNum(texture->patches[j].patch);
         }
 
+    SDL_AtomicSet(&precachecancel, 0);
+
+    if (!(precachethread = SDL_CreateThread(R_PrecacheTextures, "R_PrecacheTextures", NULL)))
+        R_PrecacheTextures(NULL);
+
     // Precache sprites.
     memset(hitlist, 0, numsprites);
 
@@ -1168,7 +1344,7 @@ void R_PrecacheLevel(void)
                 short   *lump = sprites[i].spriteframes[j].lump;
 
                 for (k = 0; k < 8; k++)
-                    W_CacheLumpNum(firstspritelump + lump[k], PU_CACHE);
+                    R_PrecacheLumpNum(firstspritelump + lump[k]);
             }
 
     free(hitlist);
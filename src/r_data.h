@@ -128,6 +128,7 @@ byte *R_GetColumn(int tex, int col, dboolean opaque);
 // I/O, setting up the stuff.
 void R_InitData(void);
 void R_PrecacheLevel(void);
+void R_StopPrecaching(void);
 
 // Retrieval.
 // Floor/ceiling opaque texture tiles,
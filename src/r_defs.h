@@ -130,9 +130,6 @@ typedef struct
     int                 linecount;
     struct line_s       **lines;                // [linecount] size
 
-    int                 cachedheight;
-    int                 scaleindex;
-
     int                 animate;
 
     // [AM] Previous position of floor and ceiling before
@@ -811,6 +808,55 @@ typedef post_t column_t;
 // Could even use more than 32 levels.
 typedef byte lighttable_t;
 
+// Everything a column drawer needs to draw a single column,
+//  filled in by the caller and passed to colfunc.
+struct column_context_s
+{
+    int                 x;
+    int                 yl;
+    int                 yh;
+
+    fixed_t             iscale;
+    fixed_t             texturemid;
+    fixed_t             texheight;
+    int                 texpadheight;
+    fixed_t             texturefrac;
+
+    lighttable_t        *colormap;
+
+    // first pixel in a column (possibly virtual)
+    byte                *source;
+
+    byte                *translation;
+    byte                *blood;
+    byte                *colormask;
+
+    dboolean            topsparkle;
+    dboolean            bottomsparkle;
+
+    // bottom of a foot clipped sprite, or -1
+    int                 baseclip;
+};
+
+// Everything a span drawer needs to draw a single span
+//  of a floor or ceiling, passed to spanfunc.
+typedef struct
+{
+    int                 y;
+    int                 x1;
+    int                 x2;
+
+    fixed_t             xfrac;
+    fixed_t             yfrac;
+    fixed_t             xstep;
+    fixed_t             ystep;
+
+    lighttable_t        *colormap;
+
+    // start of a 64*64 tile image
+    byte                *source;
+} span_context_t;
+
 typedef struct drawseg_s
 {
     seg_t               *curline;
@@ -897,7 +943,7 @@ typedef struct vissprite_s
 
     mobjtype_t          type;
 
-    void                (*colfunc)(void);
+    void                (*colfunc)(const column_context_t *);
 
     // foot clipping
     fixed_t             footclip;
@@ -38,6 +38,9 @@
 
 #include "c_console.h"
 #include "doomstat.h"
+#include "i_timer.h"
+#include "m_config.h"
+#include "m_misc.h"
 #include "m_random.h"
 #include "r_local.h"
 #include "st_stuff.h"
@@ -45,6 +48,12 @@
 #include "w_wad.h"
 #include "z_zone.h"
 
+// R_FinishColumnMajorView() transposes the view with SSE2 when the CPU supports it.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TRANSPOSE_SSE2
+#include <emmintrin.h>
+#endif
+
 //
 // All drawing to the view buffer is accomplished in this file.
 // The other refresh files only know about ccordinates,
@@ -62,6 +71,17 @@ int     viewwindowx;
 int     viewwindowy;
 int     fuzztable[SCREENWIDTH * SCREENHEIGHT];
 
+// Moving down one pixel in viewbuffer is viewpitch bytes, and across one pixel viewstride bytes.
+byte    *viewbuffer;
+int     viewpitch = SCREENWIDTH;
+int     viewstride = 1;
+
+dboolean        r_columnmajor = r_columnmajor_default;
+
+// The view drawn column by column when r_columnmajor is enabled. There is a screen's width of
+//  padding either side, since the fuzz effect reads the pixels above and below each column.
+static byte     *columnmajorbuffer;
+
 extern int      r_screensize;
 
 // Color tables for different players,
@@ -154,22 +174,6 @@ byte megasphere[] =
 // R_DrawColumn
 // Source is the top of the column to scale.
 //
-lighttable_t    *dc_colormap;
-int             dc_x;
-int             dc_yl;
-int             dc_yh;
-fixed_t         dc_iscale;
-fixed_t         dc_texturemid;
-fixed_t         dc_texheight;
-fixed_t         dc_texturefrac;
-dboolean        dc_topsparkle;
-dboolean        dc_bottomsparkle;
-byte            *dc_blood;
-byte            *dc_colormask;
-int             dc_baseclip;
-
-// first pixel in a column (possibly virtual)
-byte            *dc_source;
 
 //
 // A column is a vertical slice/span from a wall texture that,
@@ -179,122 +183,142 @@ byte            *dc_source;
 //  be used. It has also been used with Wolfenstein 3D.
 //
 
-void R_DrawColumn(void)
+void R_DrawColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[source[frac >> FRACBITS]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[source[frac >> FRACBITS]];
 }
 
-void R_DrawShadowColumn(void)
+void R_DrawShadowColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
-    byte        *dest = R_ADDRESS(0, dc_x, dc_yl);
+    int32_t     count = dc->yh - dc->yl + 1;
+    byte        *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int   pitch = viewpitch;
 
     if (--count)
     {
         *dest = tinttab25[*dest];
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     while (--count > 0)
     {
         *dest = tinttab40[*dest];
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     *dest = tinttab25[*dest];
 }
 
-void R_DrawSpectreShadowColumn(void)
+void R_DrawSpectreShadowColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
-    byte        *dest = R_ADDRESS(0, dc_x, dc_yl);
+    int32_t     count = dc->yh - dc->yl + 1;
+    byte        *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int   pitch = viewpitch;
 
     if (--count)
     {
         if (!(rand() % 4) && !consoleactive)
             *dest = tinttab25[*dest];
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     while (--count > 0)
     {
         *dest = tinttab25[*dest];
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     if (!(rand() % 4) && !consoleactive)
         *dest = tinttab25[*dest];
 }
 
-void R_DrawSolidShadowColumn(void)
+void R_DrawSolidShadowColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
-    byte        *dest = R_ADDRESS(0, dc_x, dc_yl);
+    int32_t     count = dc->yh - dc->yl + 1;
+    byte        *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int   pitch = viewpitch;
 
     while (--count > 0)
     {
         *dest = 0;
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     *dest = 0;
 }
 
-void R_DrawBloodSplatColumn(void)
+void R_DrawBloodSplatColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
-    byte        *dest = R_ADDRESS(0, dc_x, dc_yl);
-    byte        *blood = dc_blood;
+    int32_t     count = dc->yh - dc->yl + 1;
+    byte        *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int   pitch = viewpitch;
+    byte        *blood = dc->blood;
 
     while (--count > 0)
     {
         *dest = *(*dest + blood);
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     *dest = *(*dest + blood);
 }
 
-void R_DrawSolidBloodSplatColumn(void)
+void R_DrawSolidBloodSplatColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    const fixed_t       blood = *dc_blood;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    const fixed_t       blood = *dc->blood;
 
     while (--count > 0)
     {
         *dest = blood;
-        dest += SCREENWIDTH;
+        dest += pitch;
     }
     *dest = blood;
 }
 
-void R_DrawWallColumn(void)
+void R_DrawWallColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
+    int32_t     count = dc->yh - dc->yl + 1;
 
     if (count <= 0)
         return;
     else
     {
-        byte                    *dest = R_ADDRESS(0, dc_x, dc_yl);
-        const fixed_t           fracstep = dc_iscale;
-        fixed_t                 frac = dc_texturemid + (dc_yl - centery) * fracstep;
-        const byte              *source = dc_source;
-        const lighttable_t      *colormap = dc_colormap;
-        const fixed_t           texheight = dc_texheight;
+        byte                    *dest = R_VIEWADDRESS(dc->x, dc->yl);
+        const int               pitch = viewpitch;
+        const fixed_t           fracstep = dc->iscale;
+        fixed_t                 frac = dc->texturemid + (dc->yl - centery) * fracstep;
+        const byte              *source = dc->source;
+        const lighttable_t      *colormap = dc->colormap;
+        const fixed_t           texheight = dc->texheight;
         fixed_t                 heightmask = texheight - 1;
 
+        // If the texture has been padded to a power-of-2 height, and this column won't run past
+        // the end of the padding, wrap frac the once and draw it as if it were a power-of-2.
+        if ((texheight & heightmask) && dc->texpadheight)
+        {
+            const fixed_t       period = texheight << FRACBITS;
+
+            if ((frac %= period) < 0)
+                frac += period;
+
+            if (frac + (int64_t)(count - 1) * fracstep < ((int64_t)dc->texpadheight << FRACBITS))
+                heightmask = dc->texpadheight - 1;
+        }
+
         // [SL] Properly tile textures whose heights are not a power-of-2,
         // avoiding a tutti-frutti effect. From Eternity Engine.
-        if (texheight & heightmask)
+        if ((heightmask + 1) & heightmask)
         {
             heightmask++;
             heightmask <<= FRACBITS;
@@ -308,7 +332,7 @@ void R_DrawWallColumn(void)
             while (count--)
             {
                 *dest = colormap[source[frac >> FRACBITS]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 if ((frac += fracstep) >= heightmask)
                     frac -= heightmask;
             }
@@ -320,28 +344,28 @@ void R_DrawWallColumn(void)
             while (count >= 8)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 count -= 8;
             }
@@ -349,69 +373,83 @@ void R_DrawWallColumn(void)
             if (count & 1)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
             if (count & 2)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
             if (count & 4)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
         }
 
-        if (dc_bottomsparkle && !(((frac - fracstep) >> FRACBITS) & 2))
-            *(dest - SCREENWIDTH) = *(dest - SCREENWIDTH * 2);
+        if (dc->bottomsparkle && !(((frac - fracstep) >> FRACBITS) & 2))
+            *(dest - pitch) = *(dest - pitch * 2);
 
-        if (dc_topsparkle)
+        if (dc->topsparkle)
         {
-            dest = R_ADDRESS(0, dc_x, dc_yl);
-            *dest = *(dest + SCREENWIDTH);
+            dest = R_VIEWADDRESS(dc->x, dc->yl);
+            *dest = *(dest + pitch);
         }
     }
 }
 
-void R_DrawFullbrightWallColumn(void)
+void R_DrawFullbrightWallColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
+    int32_t     count = dc->yh - dc->yl + 1;
 
     if (count <= 0)
         return;
     else
     {
-        byte                    *dest = R_ADDRESS(0, dc_x, dc_yl);
-        const fixed_t           fracstep = dc_iscale;
-        fixed_t                 frac = dc_texturemid + (dc_yl - centery) * fracstep;
-        const byte              *source = dc_source;
-        const byte              *colormask = dc_colormask;
-        const lighttable_t      *colormap = dc_colormap;
-        const fixed_t           texheight = dc_texheight;
+        byte                    *dest = R_VIEWADDRESS(dc->x, dc->yl);
+        const int               pitch = viewpitch;
+        const fixed_t           fracstep = dc->iscale;
+        fixed_t                 frac = dc->texturemid + (dc->yl - centery) * fracstep;
+        const byte              *source = dc->source;
+        const byte              *colormask = dc->colormask;
+        const lighttable_t      *colormap = dc->colormap;
+        const fixed_t           texheight = dc->texheight;
         fixed_t                 heightmask = texheight - 1;
         byte                    dot;
 
+        // If the texture has been padded to a power-of-2 height, and this column won't run past
+        // the end of the padding, wrap frac the once and draw it as if it were a power-of-2.
+        if ((texheight & heightmask) && dc->texpadheight)
+        {
+            const fixed_t       period = texheight << FRACBITS;
+
+            if ((frac %= period) < 0)
+                frac += period;
+
+            if (frac + (int64_t)(count - 1) * fracstep < ((int64_t)dc->texpadheight << FRACBITS))
+                heightmask = dc->texpadheight - 1;
+        }
+
         // [SL] Properly tile textures whose heights are not a power-of-2,
         // avoiding a tutti-frutti effect. From Eternity Engine.
-        if (texheight & heightmask)
+        if ((heightmask + 1) & heightmask)
         {
             heightmask++;
             heightmask <<= FRACBITS;
@@ -426,7 +464,7 @@ void R_DrawFullbrightWallColumn(void)
             {
                 dot = source[frac >> FRACBITS];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 if ((frac += fracstep) >= heightmask)
                     frac -= heightmask;
             }
@@ -439,35 +477,35 @@ void R_DrawFullbrightWallColumn(void)
             {
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 count -= 8;
             }
@@ -476,7 +514,7 @@ void R_DrawFullbrightWallColumn(void)
             {
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
@@ -484,11 +522,11 @@ void R_DrawFullbrightWallColumn(void)
             {
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
@@ -496,58 +534,59 @@ void R_DrawFullbrightWallColumn(void)
             {
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 dot = source[(frac >> FRACBITS) & heightmask];
                 *dest = (colormask[dot] ? dot : colormap[dot]);
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
         }
 
-        if (dc_bottomsparkle && !(((frac - fracstep) >> FRACBITS) & 2))
-            *(dest - SCREENWIDTH) = *(dest - SCREENWIDTH * 2);
+        if (dc->bottomsparkle && !(((frac - fracstep) >> FRACBITS) & 2))
+            *(dest - pitch) = *(dest - pitch * 2);
 
-        if (dc_topsparkle)
+        if (dc->topsparkle)
         {
-            dest = R_ADDRESS(0, dc_x, dc_yl);
-            *dest = *(dest + SCREENWIDTH);
+            dest = R_VIEWADDRESS(dc->x, dc->yl);
+            *dest = *(dest + pitch);
         }
     }
 }
 
-void R_DrawPlayerSpriteColumn(void)
+void R_DrawPlayerSpriteColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(1, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_ADDRESS(1, dc->x, dc->yl);
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
 
     while (--count)
     {
-        *dest = dc_source[frac >> FRACBITS];
+        *dest = dc->source[frac >> FRACBITS];
         dest += SCREENWIDTH;
         frac += fracstep;
     }
-    *dest = dc_source[frac >> FRACBITS];
+    *dest = dc->source[frac >> FRACBITS];
 }
 
-void R_DrawSuperShotgunColumn(void)
+void R_DrawSuperShotgunColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
@@ -555,26 +594,27 @@ void R_DrawSuperShotgunColumn(void)
 
         if (dot != 71)
             *dest = colormap[tinttabredwhite1[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabredwhite1[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawSkyColumn(void)
+void R_DrawSkyColumn(const column_context_t *dc)
 {
-    int32_t     count = dc_yh - dc_yl + 1;
+    int32_t     count = dc->yh - dc->yl + 1;
 
     if (count <= 0)
         return;
     else
     {
-        byte                    *dest = R_ADDRESS(0, dc_x, dc_yl);
-        const fixed_t           fracstep = dc_iscale;
-        fixed_t                 frac = dc_texturemid + (dc_yl - centery) * fracstep;
-        const byte              *source = dc_source;
-        const lighttable_t      *colormap = dc_colormap;
-        const fixed_t           texheight = dc_texheight;
+        byte                    *dest = R_VIEWADDRESS(dc->x, dc->yl);
+        const int               pitch = viewpitch;
+        const fixed_t           fracstep = dc->iscale;
+        fixed_t                 frac = dc->texturemid + (dc->yl - centery) * fracstep;
+        const byte              *source = dc->source;
+        const lighttable_t      *colormap = dc->colormap;
+        const fixed_t           texheight = dc->texheight;
         fixed_t                 heightmask = texheight - 1;
 
         // [SL] Properly tile textures whose heights are not a power-of-2,
@@ -593,7 +633,7 @@ void R_DrawSkyColumn(void)
             while (count--)
             {
                 *dest = colormap[source[frac >> FRACBITS]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 if ((frac += fracstep) >= heightmask)
                     frac -= heightmask;
             }
@@ -605,28 +645,28 @@ void R_DrawSkyColumn(void)
             while (count >= 8)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 count -= 8;
             }
@@ -634,30 +674,30 @@ void R_DrawSkyColumn(void)
             if (count & 1)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
             if (count & 2)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
             }
 
             if (count & 4)
             {
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
-                dest += SCREENWIDTH;
+                dest += pitch;
                 frac += fracstep;
                 *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
             }
@@ -665,346 +705,365 @@ void R_DrawSkyColumn(void)
     }
 }
 
-void R_DrawFlippedSkyColumn(void)
+void R_DrawFlippedSkyColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    const fixed_t       fracstep = dc_iscale;
-    fixed_t             frac = dc_texturemid + (dc_yl - centery) * fracstep;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    const fixed_t       fracstep = dc->iscale;
+    fixed_t             frac = dc->texturemid + (dc->yl - centery) * fracstep;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
     fixed_t             i;
 
     while (--count)
     {
         i = frac >> FRACBITS;
         *dest = colormap[source[i > 127 ? 126 - (i & 127) : i]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     i = frac >> FRACBITS;
     *dest = colormap[source[i > 127 ? 126 - (i & 127) : i]];
 }
 
-void R_DrawRedToBlueColumn(void)
+void R_DrawRedToBlueColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[redtoblue[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[redtoblue[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedToBlue33Column(void)
+void R_DrawTranslucentRedToBlue33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab33[(*dest << 8) + colormap[redtoblue[source[frac >> FRACBITS]]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab33[(*dest << 8) + colormap[redtoblue[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawRedToGreenColumn(void)
+void R_DrawRedToGreenColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[redtogreen[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[redtogreen[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedToGreen33Column(void)
+void R_DrawTranslucentRedToGreen33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab33[(*dest << 8) + colormap[redtogreen[source[frac >> FRACBITS]]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab33[(*dest << 8) + colormap[redtogreen[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawTranslucentColumn(void)
+void R_DrawTranslucentColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucent50Column(void)
+void R_DrawTranslucent50Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab50[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab50[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucent33Column(void)
+void R_DrawTranslucent33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab33[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab33[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawMegaSphereColumn(void)
+void R_DrawMegaSphereColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttab33[(*dest << 8) + colormap[megasphere[source[frac >> FRACBITS]]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttab33[(*dest << 8) + colormap[megasphere[source[frac >> FRACBITS]]]];
 }
 
-void R_DrawSolidMegaSphereColumn(void)
+void R_DrawSolidMegaSphereColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[megasphere[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[megasphere[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedColumn(void)
+void R_DrawTranslucentRedColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttabred[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttabred[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedWhiteColumn1(void)
+void R_DrawTranslucentRedWhiteColumn1(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
     
     while (--count)
     {
         *dest = colormap[tinttabredwhite1[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabredwhite1[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedWhiteColumn2(void)
+void R_DrawTranslucentRedWhiteColumn2(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[tinttabredwhite2[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabredwhite2[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRedWhite50Column(void)
+void R_DrawTranslucentRedWhite50Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[tinttabredwhite50[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabredwhite50[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentGreenColumn(void)
+void R_DrawTranslucentGreenColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttabgreen[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttabgreen[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentBlueColumn(void)
+void R_DrawTranslucentBlueColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = tinttabblue[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = tinttabblue[(*dest << 8) + colormap[source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentRed33Column(void)
+void R_DrawTranslucentRed33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[tinttabred33[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabred33[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentGreen33Column(void)
+void R_DrawTranslucentGreen33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[tinttabgreen33[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabgreen33[(*dest << 8) + source[frac >> FRACBITS]]];
 }
 
-void R_DrawTranslucentBlue33Column(void)
+void R_DrawTranslucentBlue33Column(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
 
     while (--count)
     {
         *dest = colormap[tinttabblue33[(*dest << 8) + source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[tinttabblue33[(*dest << 8) + source[frac >> FRACBITS]]];
@@ -1013,73 +1072,75 @@ void R_DrawTranslucentBlue33Column(void)
 //
 // Spectre/Invisibility.
 //
-extern int      fuzzpos;
+extern THREADLOCAL int fuzzpos;
 
 int             fuzzrange[3] = { -SCREENWIDTH, 0, SCREENWIDTH };
 
 #define FUZZ(a, b)      fuzzrange[rand() % (b - a + 1) + a]
 #define NOFUZZ          251
 
-void R_DrawFuzzColumn(void)
+void R_DrawFuzzColumn(const column_context_t *dc)
 {
     byte        *dest;
-    int         count = dc_yh - dc_yl;
+    const int   pitch = viewpitch;
+    int         count = dc->yh - dc->yl;
 
     if (count < 0)
         return;
 
-    dest = R_ADDRESS(0, dc_x, dc_yl);
+    dest = R_VIEWADDRESS(dc->x, dc->yl);
 
     if (count)
     {
         // top
-        if (!dc_yl)
+        if (!dc->yl)
             *dest = fullcolormap[6 * 256 + dest[(fuzztable[fuzzpos++] = FUZZ(1, 2))]];
         else if (!(rand() % 4))
             *dest = fullcolormap[12 * 256 + dest[(fuzztable[fuzzpos++] = FUZZ(0, 2))]];
-        dest += SCREENWIDTH;
+        dest += pitch;
 
         while (--count)
         {
             // middle
             *dest = fullcolormap[6 * 256 + dest[(fuzztable[fuzzpos++] = FUZZ(0, 2))]];
-            dest += SCREENWIDTH;
+            dest += pitch;
         }
 
         // bottom
-        if (dc_yh == viewheight - 1)
+        if (dc->yh == viewheight - 1)
             *dest = fullcolormap[5 * 256 + dest[(fuzztable[fuzzpos] = FUZZ(0, 1))]];
-        else if (dc_baseclip == -1 && !(rand() % 4))
+        else if (dc->baseclip == -1 && !(rand() % 4))
             *dest = fullcolormap[14 * 256 + dest[(fuzztable[fuzzpos] = FUZZ(0, 1))]];
     }
 }
 
-void R_DrawPausedFuzzColumn(void)
+void R_DrawPausedFuzzColumn(const column_context_t *dc)
 {
     byte        *dest;
-    int         count = dc_yh - dc_yl;
+    const int   pitch = viewpitch;
+    int         count = dc->yh - dc->yl;
 
     if (count < 0)
         return;
 
-    dest = R_ADDRESS(0, dc_x, dc_yl);
+    dest = R_VIEWADDRESS(dc->x, dc->yl);
 
     if (count)
     {
         // top
-        if (!dc_yl)
+        if (!dc->yl)
             *dest = fullcolormap[6 * 256 + dest[fuzztable[fuzzpos++]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
 
         while (--count)
         {
             // middle
             *dest = fullcolormap[6 * 256 + dest[fuzztable[fuzzpos++]]];
-            dest += SCREENWIDTH;
+            dest += pitch;
         }
 
         // bottom
-        if (dc_yh == viewheight - 1)
+        if (dc->yh == viewheight - 1)
             *dest = fullcolormap[5 * 256 + dest[fuzztable[fuzzpos]]];
     }
 }
@@ -1186,23 +1247,23 @@ void R_DrawPausedFuzzColumns(void)
 //  of the BaronOfHell, the HellKnight, uses
 //  identical sprites, kinda brightened up.
 //
-byte    *dc_translation;
 byte    *translationtables;
 
-void R_DrawTranslatedColumn(void)
+void R_DrawTranslatedColumn(const column_context_t *dc)
 {
-    int32_t             count = dc_yh - dc_yl + 1;
-    byte                *dest = R_ADDRESS(0, dc_x, dc_yl);
-    fixed_t             frac = dc_texturefrac;
-    const fixed_t       fracstep = dc_iscale;
-    const byte          *source = dc_source;
-    const lighttable_t  *colormap = dc_colormap;
-    const byte          *translation = dc_translation;
+    int32_t             count = dc->yh - dc->yl + 1;
+    byte                *dest = R_VIEWADDRESS(dc->x, dc->yl);
+    const int           pitch = viewpitch;
+    fixed_t             frac = dc->texturefrac;
+    const fixed_t       fracstep = dc->iscale;
+    const byte          *source = dc->source;
+    const lighttable_t  *colormap = dc->colormap;
+    const byte          *translation = dc->translation;
 
     while (--count)
     {
         *dest = colormap[translation[source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
     }
     *dest = colormap[translation[source[frac >> FRACBITS]]];
@@ -1247,33 +1308,19 @@ void R_InitTranslationTables(void)
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int             ds_y;
-int             ds_x1;
-int             ds_x2;
-
-lighttable_t    *ds_colormap;
-
-fixed_t         ds_xfrac;
-fixed_t         ds_yfrac;
-fixed_t         ds_xstep;
-fixed_t         ds_ystep;
-
-// start of a 64*64 tile image
-byte            *ds_source;
-
 //
 // Draws the actual span.
 //
-void R_DrawSpan(void)
+void R_DrawSpan(const span_context_t *ds)
 {
-    unsigned int        count = ds_x2 - ds_x1 + 1;
-    byte                *dest = R_ADDRESS(0, ds_x1, ds_y);
-    fixed_t             xfrac = ds_xfrac;
-    fixed_t             yfrac = ds_yfrac;
-    const fixed_t       xstep = ds_xstep;
-    const fixed_t       ystep = ds_ystep;
-    const byte          *source = ds_source;
-    const lighttable_t  *colormap = ds_colormap;
+    unsigned int        count = ds->x2 - ds->x1 + 1;
+    byte                *dest = R_VIEWADDRESS(ds->x1, ds->y);
+    fixed_t             xfrac = ds->xfrac;
+    fixed_t             yfrac = ds->yfrac;
+    const fixed_t       xstep = ds->xstep;
+    const fixed_t       ystep = ds->ystep;
+    const byte          *source = ds->source;
+    const lighttable_t  *colormap = ds->colormap;
 
     while (count >= 4)
     {
@@ -1299,6 +1346,32 @@ void R_DrawSpan(void)
     }
 }
 
+//
+// R_DrawColumnMajorSpan
+// Draws a span into a column-major view, where each pixel
+//  is a column's height apart.
+//
+void R_DrawColumnMajorSpan(const span_context_t *ds)
+{
+    unsigned int        count = ds->x2 - ds->x1 + 1;
+    byte                *dest = R_VIEWADDRESS(ds->x1, ds->y);
+    const int           stride = viewstride;
+    fixed_t             xfrac = ds->xfrac;
+    fixed_t             yfrac = ds->yfrac;
+    const fixed_t       xstep = ds->xstep;
+    const fixed_t       ystep = ds->ystep;
+    const byte          *source = ds->source;
+    const lighttable_t  *colormap = ds->colormap;
+
+    while (count-- > 0)
+    {
+        *dest = colormap[source[((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032)]];
+        dest += stride;
+        xfrac += xstep;
+        yfrac += ystep;
+    }
+}
+
 //
 // R_InitBuffer
 // Creates lookup tables that avoid
@@ -1313,6 +1386,148 @@ void R_InitBuffer(int width, int height)
 
     // Same with base row offset.
     viewwindowy = (width == SCREENWIDTH ? 0 : (SCREENHEIGHT - SBARHEIGHT - height) >> 1);
+
+    viewbuffer = R_ADDRESS(0, 0, 0);
+}
+
+static void (*rowmajorspanfunc)(const span_context_t *);
+
+static void R_SetViewBuffer(byte *buffer, int pitch, int stride)
+{
+    viewbuffer = buffer;
+    viewpitch = pitch;
+    viewstride = stride;
+
+    fuzzrange[0] = -pitch;
+    fuzzrange[2] = pitch;
+}
+
+//
+// R_StartColumnMajorView
+// Directs drawing of the view into a buffer stored column by
+//  column, so that walls and sprites are drawn into memory
+//  that is contiguous rather than a screen's width apart.
+//
+void R_StartColumnMajorView(void)
+{
+    if (!columnmajorbuffer)
+        columnmajorbuffer = (byte *)Z_Malloc(SCREENWIDTH * SCREENHEIGHT + SCREENWIDTH * 2, PU_STATIC, NULL)
+            + SCREENWIDTH;
+
+    R_SetViewBuffer(columnmajorbuffer, 1, SCREENHEIGHT);
+
+    rowmajorspanfunc = spanfunc;
+    spanfunc = R_DrawColumnMajorSpan;
+}
+
+#if defined(TRANSPOSE_SSE2)
+static const int transposedrow[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+
+//
+// R_TransposeBlockSSE2
+// Transposes a block of 16x16 pixels by interleaving
+//  the 16 columns twice as far apart in each of 4 steps.
+//  The rows come out in bit-reversed order.
+//
+#if defined(__GNUC__)
+__attribute__((target("sse2")))
+#endif
+static void R_TransposeBlockSSE2(const byte *src, byte *dest)
+{
+    __m128i     a[16];
+    __m128i     b[16];
+    int         i;
+
+    for (i = 0; i < 16; i++)
+        a[i] = _mm_loadu_si128((const __m128i *)(src + i * SCREENHEIGHT));
+
+    for (i = 0; i < 8; i++)
+    {
+        b[i] = _mm_unpacklo_epi8(a[i * 2], a[i * 2 + 1]);
+        b[i + 8] = _mm_unpackhi_epi8(a[i * 2], a[i * 2 + 1]);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        a[i] = _mm_unpacklo_epi16(b[i * 2], b[i * 2 + 1]);
+        a[i + 8] = _mm_unpackhi_epi16(b[i * 2], b[i * 2 + 1]);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        b[i] = _mm_unpacklo_epi32(a[i * 2], a[i * 2 + 1]);
+        b[i + 8] = _mm_unpackhi_epi32(a[i * 2], a[i * 2 + 1]);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        a[i] = _mm_unpacklo_epi64(b[i * 2], b[i * 2 + 1]);
+        a[i + 8] = _mm_unpackhi_epi64(b[i * 2], b[i * 2 + 1]);
+    }
+
+    for (i = 0; i < 16; i++)
+        _mm_storeu_si128((__m128i *)(dest + transposedrow[i] * SCREENWIDTH), a[i]);
+}
+#endif
+
+static void R_TransposeBlock(const byte *src, byte *dest, int width, int height)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+            dest[y * SCREENWIDTH + x] = src[x * SCREENHEIGHT + y];
+}
+
+//
+// R_FinishColumnMajorView
+// Transposes the view into screens[0] a block at a time, so
+//  that both buffers are read and written a cache line at a time,
+//  and then directs drawing back to screens[0].
+//
+void R_FinishColumnMajorView(void)
+{
+    byte        *dest = R_ADDRESS(0, 0, 0);
+    int         x;
+    int         y;
+#if defined(TRANSPOSE_SSE2)
+    const dboolean      sse2 = (SDL_HasSSE2() == SDL_TRUE);
+#endif
+
+    for (x = 0; x < viewwidth; x += 16)
+    {
+        const int       width = MIN(16, viewwidth - x);
+
+        for (y = 0; y < viewheight; y += 16)
+        {
+            const int   height = MIN(16, viewheight - y);
+            const byte  *block = columnmajorbuffer + x * SCREENHEIGHT + y;
+
+#if defined(TRANSPOSE_SSE2)
+            if (sse2 && width == 16 && height == 16)
+                R_TransposeBlockSSE2(block, dest + y * SCREENWIDTH + x);
+            else
+#endif
+                R_TransposeBlock(block, dest + y * SCREENWIDTH + x, width, height);
+        }
+    }
+
+    R_SetViewBuffer(dest, SCREENWIDTH, 1);
+
+    spanfunc = rowmajorspanfunc;
+}
+
+//
+// R_FillView
+// Fills the view with a color, for the HOM indicator and noclip.
+//
+void R_FillView(int color)
+{
+    if (viewbuffer == columnmajorbuffer)
+        memset(columnmajorbuffer, color, SCREENHEIGHT * viewwidth);
+    else
+        V_FillRect(0, viewwindowx, viewwindowy, viewwidth, viewheight, color);
 }
 
 //
@@ -1431,3 +1646,141 @@ void R_DrawViewBorder(void)
         ofs += SCREENWIDTH;
     }
 }
+
+//
+// DRAWER BENCHMARK
+//
+// When started with -drawbench, each of the most used drawers is timed
+//  filling the view over and over again with a synthetic column or span,
+//  and the number of pixels drawn a second is reported.
+//
+#define DRAWBENCHFRAMES 200
+
+static byte     drawbenchsource[128 * 128];
+
+static void R_ReportDrawerBenchmark(const char *name, uint64_t time)
+{
+    const int   pixels = viewwidth * viewheight * DRAWBENCHFRAMES;
+    char        buffer[256];
+
+    M_snprintf(buffer, sizeof(buffer), "%s drew %s pixels in %.3fms (%.1f million pixels a "
+        "second).", name, commify(pixels), time / 1000.0, (double)pixels / MAX(1, time));
+
+    C_Output(buffer);
+    fprintf(stdout, "%s\n", buffer);
+    fflush(stdout);
+}
+
+static void R_BenchmarkColumnDrawer(const char *name, void (*drawer)(const column_context_t *),
+    int texheight)
+{
+    column_context_t    dc;
+    uint64_t            start;
+    int                 i;
+
+    memset(&dc, 0, sizeof(dc));
+    dc.yl = 0;
+    dc.yh = viewheight - 1;
+    dc.iscale = FRACUNIT / 4;
+    dc.texheight = texheight;
+    dc.colormap = colormaps[0];
+    dc.source = drawbenchsource;
+    dc.translation = translationtables;
+    dc.baseclip = -1;
+
+    start = I_GetTimeUS();
+
+    for (i = 0; i < DRAWBENCHFRAMES; i++)
+        for (dc.x = 0; dc.x < viewwidth; dc.x++)
+            drawer(&dc);
+
+    R_ReportDrawerBenchmark(name, I_GetTimeUS() - start);
+}
+
+static void R_BenchmarkSpanDrawer(const char *name, void (*drawer)(const span_context_t *))
+{
+    span_context_t      ds;
+    uint64_t            start;
+    int                 i;
+
+    ds.x1 = 0;
+    ds.x2 = viewwidth - 1;
+    ds.xstep = FRACUNIT / 3;
+    ds.ystep = FRACUNIT / 5;
+    ds.colormap = colormaps[0];
+    ds.source = drawbenchsource;
+
+    start = I_GetTimeUS();
+
+    for (i = 0; i < DRAWBENCHFRAMES; i++)
+        for (ds.y = 0; ds.y < viewheight; ds.y++)
+        {
+            ds.xfrac = ds.y << FRACBITS;
+            ds.yfrac = -ds.y << FRACBITS;
+            drawer(&ds);
+        }
+
+    R_ReportDrawerBenchmark(name, I_GetTimeUS() - start);
+}
+
+// Draws frames of walls with a translucent sprite across the middle, either straight into screens[0]
+//  or into the column-major buffer and then transposed.
+static void R_BenchmarkView(const char *name, dboolean columnmajor)
+{
+    column_context_t    dc;
+    uint64_t            start;
+    int                 i;
+
+    memset(&dc, 0, sizeof(dc));
+    dc.iscale = FRACUNIT / 4;
+    dc.texheight = 128;
+    dc.colormap = colormaps[0];
+    dc.source = drawbenchsource;
+
+    start = I_GetTimeUS();
+
+    for (i = 0; i < DRAWBENCHFRAMES; i++)
+    {
+        if (columnmajor)
+            R_StartColumnMajorView();
+
+        dc.yl = 0;
+        dc.yh = viewheight - 1;
+
+        for (dc.x = 0; dc.x < viewwidth; dc.x++)
+            R_DrawWallColumn(&dc);
+
+        dc.yl = viewheight / 4;
+        dc.yh = viewheight * 3 / 4;
+
+        for (dc.x = viewwidth / 4; dc.x < viewwidth * 3 / 4; dc.x++)
+            R_DrawTranslucentColumn(&dc);
+
+        if (columnmajor)
+            R_FinishColumnMajorView();
+    }
+
+    R_ReportDrawerBenchmark(name, I_GetTimeUS() - start);
+}
+
+//
+// R_BenchmarkDrawers
+// The view size must already have been set.
+//
+void R_BenchmarkDrawers(void)
+{
+    int i;
+
+    for (i = 0; i < sizeof(drawbenchsource); i++)
+        drawbenchsource[i] = M_Random();
+
+    R_BenchmarkColumnDrawer("R_DrawColumn()", R_DrawColumn, 128);
+    R_BenchmarkColumnDrawer("R_DrawWallColumn()", R_DrawWallColumn, 128);
+    R_BenchmarkColumnDrawer("R_DrawWallColumn() (non-power-of-2)", R_DrawWallColumn, 72);
+    R_BenchmarkColumnDrawer("R_DrawTranslatedColumn()", R_DrawTranslatedColumn, 128);
+    R_BenchmarkColumnDrawer("R_DrawTranslucentColumn()", R_DrawTranslucentColumn, 128);
+    R_BenchmarkColumnDrawer("R_DrawSkyColumn()", R_DrawSkyColumn, 128);
+    R_BenchmarkSpanDrawer("R_DrawSpan()", R_DrawSpan);
+    R_BenchmarkView("A row-major view", false);
+    R_BenchmarkView("A column-major view", true);
+}
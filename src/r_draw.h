@@ -42,23 +42,13 @@
 #define R_ADDRESS(scrn, px, py) \
     (screens[scrn] + (viewwindowy + (py)) * SCREENWIDTH + (viewwindowx + (px)))
 
-extern lighttable_t     *dc_colormap;
-extern int              dc_x;
-extern int              dc_yl;
-extern int              dc_yh;
-extern fixed_t          dc_iscale;
-extern fixed_t          dc_texturemid;
-extern fixed_t          dc_texheight;
-extern fixed_t          dc_texturefrac;
-extern dboolean         dc_topsparkle;
-extern dboolean         dc_bottomsparkle;
-extern byte             *dc_blood;
-extern byte             *dc_colormask;
-extern byte             *dc_tranmap;
-extern int              dc_baseclip;
-
-// first pixel in a column
-extern byte             *dc_source;
+// The 3D view is drawn into viewbuffer, which is either screens[0] or, if r_columnmajor is
+//  enabled, a separate buffer stored column by column that is transposed into screens[0].
+#define R_VIEWADDRESS(px, py)   (viewbuffer + (px) * viewstride + (py) * viewpitch)
+
+extern byte             *viewbuffer;
+extern int              viewpitch;
+extern int              viewstride;
 
 extern byte             *tranmap_solid;
 
@@ -81,72 +71,62 @@ extern byte             *tinttabblue33;
 // The span blitting interface.
 // Hook in assembler or system specific BLT
 //  here.
-void R_DrawColumn(void);
-void R_DrawWallColumn(void);
-void R_DrawFullbrightWallColumn(void);
-void R_DrawSkyColumn(void);
-void R_DrawFlippedSkyColumn(void);
-void R_DrawTranslucentColumn(void);
-void R_DrawTranslucent50Column(void);
-void R_DrawTranslucent33Column(void);
-void R_DrawTranslucentGreenColumn(void);
-void R_DrawTranslucentRedColumn(void);
-void R_DrawTranslucentRedWhiteColumn1(void);
-void R_DrawTranslucentRedWhiteColumn2(void);
-void R_DrawTranslucentRedWhite50Column(void);
-void R_DrawTranslucentBlueColumn(void);
-void R_DrawTranslucentGreen33Column(void);
-void R_DrawTranslucentRed33Column(void);
-void R_DrawTranslucentBlue33Column(void);
-void R_DrawRedToBlueColumn(void);
-void R_DrawTranslucentRedToBlue33Column(void);
-void R_DrawRedToGreenColumn(void);
-void R_DrawTranslucentRedToGreen33Column(void);
-void R_DrawPlayerSpriteColumn(void);
-void R_DrawSuperShotgunColumn(void);
-void R_DrawShadowColumn(void);
-void R_DrawSpectreShadowColumn(void);
-void R_DrawSolidShadowColumn(void);
-void R_DrawBloodSplatColumn(void);
-void R_DrawSolidBloodSplatColumn(void);
-void R_DrawMegaSphereColumn(void);
-void R_DrawSolidMegaSphereColumn(void);
+void R_DrawColumn(const column_context_t *dc);
+void R_DrawWallColumn(const column_context_t *dc);
+void R_DrawFullbrightWallColumn(const column_context_t *dc);
+void R_DrawSkyColumn(const column_context_t *dc);
+void R_DrawFlippedSkyColumn(const column_context_t *dc);
+void R_DrawTranslucentColumn(const column_context_t *dc);
+void R_DrawTranslucent50Column(const column_context_t *dc);
+void R_DrawTranslucent33Column(const column_context_t *dc);
+void R_DrawTranslucentGreenColumn(const column_context_t *dc);
+void R_DrawTranslucentRedColumn(const column_context_t *dc);
+void R_DrawTranslucentRedWhiteColumn1(const column_context_t *dc);
+void R_DrawTranslucentRedWhiteColumn2(const column_context_t *dc);
+void R_DrawTranslucentRedWhite50Column(const column_context_t *dc);
+void R_DrawTranslucentBlueColumn(const column_context_t *dc);
+void R_DrawTranslucentGreen33Column(const column_context_t *dc);
+void R_DrawTranslucentRed33Column(const column_context_t *dc);
+void R_DrawTranslucentBlue33Column(const column_context_t *dc);
+void R_DrawRedToBlueColumn(const column_context_t *dc);
+void R_DrawTranslucentRedToBlue33Column(const column_context_t *dc);
+void R_DrawRedToGreenColumn(const column_context_t *dc);
+void R_DrawTranslucentRedToGreen33Column(const column_context_t *dc);
+void R_DrawPlayerSpriteColumn(const column_context_t *dc);
+void R_DrawSuperShotgunColumn(const column_context_t *dc);
+void R_DrawShadowColumn(const column_context_t *dc);
+void R_DrawSpectreShadowColumn(const column_context_t *dc);
+void R_DrawSolidShadowColumn(const column_context_t *dc);
+void R_DrawBloodSplatColumn(const column_context_t *dc);
+void R_DrawSolidBloodSplatColumn(const column_context_t *dc);
+void R_DrawMegaSphereColumn(const column_context_t *dc);
+void R_DrawSolidMegaSphereColumn(const column_context_t *dc);
 
 // The Spectre/Invisibility effect.
-void R_DrawFuzzColumn(void);
-void R_DrawPausedFuzzColumn(void);
+void R_DrawFuzzColumn(const column_context_t *dc);
+void R_DrawPausedFuzzColumn(const column_context_t *dc);
 void R_DrawFuzzColumns(void);
 void R_DrawPausedFuzzColumns(void);
 
 // Draw with color translation tables,
 //  for player sprite rendering,
 //  Green/Red/Blue/Indigo shirts.
-void R_DrawTranslatedColumn(void);
+void R_DrawTranslatedColumn(const column_context_t *dc);
 
 void R_VideoErase(unsigned int ofs, int count);
 
-extern int              ds_y;
-extern int              ds_x1;
-extern int              ds_x2;
-
-extern lighttable_t     *ds_colormap;
-
-extern fixed_t          ds_xfrac;
-extern fixed_t          ds_yfrac;
-extern fixed_t          ds_xstep;
-extern fixed_t          ds_ystep;
-
-// start of a 64*64 tile image
-extern byte             *ds_source;
-
 extern byte             *translationtables;
-extern byte             *dc_translation;
 
 // Span blitting for rows, floor/ceiling.
 // No Spectre effect needed.
-void R_DrawSpan(void);
+void R_DrawSpan(const span_context_t *ds);
+
+void R_DrawColumnMajorSpan(const span_context_t *ds);
 
 void R_InitBuffer(int width, int height);
+void R_StartColumnMajorView(void);
+void R_FinishColumnMajorView(void);
+void R_FillView(int color);
 
 // Initialize color translation tables,
 //  for player rendering etc.
@@ -158,4 +138,7 @@ void R_FillBackScreen(void);
 // If the view size is not full screen, draws a border around it.
 void R_DrawViewBorder(void);
 
+// Times the drawers for -drawbench.
+void R_BenchmarkDrawers(void);
+
 #endif
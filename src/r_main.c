@@ -42,6 +42,7 @@
 
 #include "c_console.h"
 #include "d_loop.h"
+#include "d_main.h"
 #include "doomstat.h"
 #include "i_timer.h"
 #include "m_config.h"
@@ -50,14 +51,39 @@
 #include "r_sky.h"
 #include "v_video.h"
 
+#include "SDL.h"
+
 // Fineangles in the SCREENWIDTH wide window.
 #define FIELDOFVIEW     2048
 
+#define MAXRENDERTHREADS        r_threads_max
+
 // increment every time a check is made
 int                     validcount = 1;
 
 lighttable_t            *fixedcolormap;
-extern lighttable_t     **walllights;
+extern THREADLOCAL lighttable_t **walllights;
+
+// killough 3/20/98: localize scalelightfixed (readability/optimization)
+static lighttable_t     *scalelightfixed[MAXLIGHTSCALE];
+
+// The columns of the view being rendered by the current thread.
+THREADLOCAL int         stripx1;
+THREADLOCAL int         stripx2;
+
+int                     r_threads = r_threads_default;
+
+typedef struct
+{
+    SDL_Thread          *thread;
+    SDL_sem             *start;
+    SDL_sem             *done;
+    int                 x1, x2;
+} renderstrip_t;
+
+static renderstrip_t    renderstrips[MAXRENDERTHREADS];
+static int              numrenderthreads = 1;
+static dboolean         renderingstrips;
 
 int                     centerx;
 int                     centery;
@@ -125,34 +151,37 @@ int                     r_frame_count;
 extern int              viewheight2;
 extern int              gametic;
 extern dboolean         canmodify;
-
-void (*colfunc)(void);
-void (*wallcolfunc)(void);
-void (*fbwallcolfunc)(void);
-void (*basecolfunc)(void);
-void (*fuzzcolfunc)(void);
-void (*tlcolfunc)(void);
-void (*tl50colfunc)(void);
-void (*tl33colfunc)(void);
-void (*tlgreencolfunc)(void);
-void (*tlredcolfunc)(void);
-void (*tlredwhitecolfunc1)(void);
-void (*tlredwhitecolfunc2)(void);
-void (*tlredwhite50colfunc)(void);
-void (*tlbluecolfunc)(void);
-void (*tlgreen33colfunc)(void);
-void (*tlred33colfunc)(void);
-void (*tlblue33colfunc)(void);
-void (*redtobluecolfunc)(void);
-void (*transcolfunc)(void);
-void (*spanfunc)(void);
-void (*skycolfunc)(void);
-void (*redtogreencolfunc)(void);
-void (*tlredtoblue33colfunc)(void);
-void (*tlredtogreen33colfunc)(void);
-void (*psprcolfunc)(void);
-void (*bloodsplatcolfunc)(void);
-void (*megaspherecolfunc)(void);
+extern dboolean         inhelpscreens;
+extern dboolean         r_columnmajor;
+extern dboolean         r_playersprites;
+
+THREADLOCAL void (*colfunc)(const column_context_t *);
+void (*wallcolfunc)(const column_context_t *);
+void (*fbwallcolfunc)(const column_context_t *);
+void (*basecolfunc)(const column_context_t *);
+void (*fuzzcolfunc)(const column_context_t *);
+void (*tlcolfunc)(const column_context_t *);
+void (*tl50colfunc)(const column_context_t *);
+void (*tl33colfunc)(const column_context_t *);
+void (*tlgreencolfunc)(const column_context_t *);
+void (*tlredcolfunc)(const column_context_t *);
+void (*tlredwhitecolfunc1)(const column_context_t *);
+void (*tlredwhitecolfunc2)(const column_context_t *);
+void (*tlredwhite50colfunc)(const column_context_t *);
+void (*tlbluecolfunc)(const column_context_t *);
+void (*tlgreen33colfunc)(const column_context_t *);
+void (*tlred33colfunc)(const column_context_t *);
+void (*tlblue33colfunc)(const column_context_t *);
+void (*redtobluecolfunc)(const column_context_t *);
+void (*transcolfunc)(const column_context_t *);
+void (*spanfunc)(const span_context_t *);
+void (*skycolfunc)(const column_context_t *);
+void (*redtogreencolfunc)(const column_context_t *);
+void (*tlredtoblue33colfunc)(const column_context_t *);
+void (*tlredtogreen33colfunc)(const column_context_t *);
+void (*psprcolfunc)(const column_context_t *);
+void (*bloodsplatcolfunc)(const column_context_t *);
+void (*megaspherecolfunc)(const column_context_t *);
 
 //
 // R_PointOnSide
@@ -344,6 +373,10 @@ static void R_InitPointToAngle(void)
 // e6y: caching
 angle_t R_GetVertexViewAngle(vertex_t *v)
 {
+    // vertices are shared between strips, so don't cache while rendering more than one
+    if (renderingstrips)
+        return R_PointToAngle(v->x, v->y);
+
     if (v->angletime != r_frame_count)
     {
         v->angletime = r_frame_count;
@@ -657,13 +690,13 @@ void R_InitColumnFunctions(void)
 void R_Init(void)
 {
     R_InitData();
-    R_InitPointToAngle();
-    R_InitTables();
+    D_StartTask("R_InitPointToAngle", R_InitPointToAngle);
+    D_StartTask("R_InitTables", R_InitTables);
 
     R_SetViewSize(r_screensize);
-    R_InitLightTables();
+    D_StartTask("R_InitLightTables", R_InitLightTables);
     R_InitSkyMap();
-    R_InitTranslationTables();
+    D_RunTask("R_InitTranslationTables", R_InitTranslationTables);
     R_InitColumnFunctions();
 }
 
@@ -686,6 +719,7 @@ subsector_t *R_PointInSubsector(fixed_t x, fixed_t y)
 void R_SetupFrame(player_t *player)
 {
     int cm;
+    int i;
 
     viewplayer = player;
 
@@ -695,6 +729,10 @@ void R_SetupFrame(player_t *player)
     if (!vid_capfps)
         fractionaltic = I_GetTimeMS() * TICRATE % 1000 * FRACUNIT / 1000;
 
+    // Interpolate every sector up front, since strips may share them
+    for (i = 0; i < numsectors; i++)
+        R_MaybeInterpolateSector(&sectors[i]);
+
     if (!vid_capfps
         // Don't interpolate on the first tic of a level, otherwise
         // oldviewz might be garbage.
@@ -744,15 +782,9 @@ void R_SetupFrame(player_t *player)
 
     if (player->fixedcolormap)
     {
-        // killough 3/20/98: localize scalelightfixed (readability/optimization)
-        static lighttable_t     *scalelightfixed[MAXLIGHTSCALE];
-        int                     i;
-
         fixedcolormap = fullcolormap   // killough 3/20/98: use fullcolormap
             + player->fixedcolormap * 256 * sizeof(lighttable_t);
 
-        walllights = scalelightfixed;
-
         for (i = 0; i < MAXLIGHTSCALE; i++)
             scalelightfixed[i] = fixedcolormap;
     }
@@ -763,37 +795,134 @@ void R_SetupFrame(player_t *player)
 }
 
 //
-// R_RenderView
+// R_StartStrip
+// Clear the buffers of the current thread before rendering columns x1 to x2.
 //
-void R_RenderPlayerView(player_t *player)
+static void R_StartStrip(int x1, int x2)
 {
-    r_frame_count++;
+    stripx1 = x1;
+    stripx2 = x2;
 
-    R_SetupFrame(player);
+    if (fixedcolormap)
+        walllights = scalelightfixed;
 
-    // Clear buffers.
     R_ClearClipSegs();
     R_ClearDrawSegs();
     R_ClearPlanes();
     R_ClearSprites();
+}
+
+//
+// R_RenderStrip
+//
+static void R_RenderStrip(int x1, int x2)
+{
+    R_StartStrip(x1, x2);
+
+    // The head node is the last node output.
+    R_RenderBSPNode(numnodes - 1);
+
+    R_DrawPlanes();
+    R_DrawMasked();
+}
+
+//
+// R_RenderStripThread
+//
+static int R_RenderStripThread(void *data)
+{
+    renderstrip_t   *strip = data;
+
+    while (true)
+    {
+        SDL_SemWait(strip->start);
+        R_RenderStrip(strip->x1, strip->x2);
+        SDL_SemPost(strip->done);
+    }
+
+    return 0;
+}
+
+//
+// R_StartRenderThreads
+// Create any threads needed to render r_threads strips that haven't been already.
+//
+static void R_StartRenderThreads(void)
+{
+    int threads = BETWEEN(1, r_threads, MAXRENDERTHREADS);
+
+    while (numrenderthreads < threads)
+    {
+        renderstrip_t   *strip = &renderstrips[numrenderthreads];
+
+        strip->start = SDL_CreateSemaphore(0);
+        strip->done = SDL_CreateSemaphore(0);
+
+        if (!strip->start || !strip->done
+            || !(strip->thread = SDL_CreateThread(R_RenderStripThread, "R_RenderStrip", strip)))
+        {
+            C_Warning("Only %i threads could be created to render the view.", numrenderthreads);
+            r_threads = numrenderthreads;
+            break;
+        }
+
+        numrenderthreads++;
+    }
+}
+
+//
+// R_RenderView
+//
+void R_RenderPlayerView(player_t *player)
+{
+    r_frame_count++;
+
+    R_SetupFrame(player);
 
     if (automapactive)
     {
-        // The head node is the last node output.
+        // Walk the BSP tree to mark the lines seen
+        R_StartStrip(0, viewwidth - 1);
         R_RenderBSPNode(numnodes - 1);
     }
     else
     {
+        const dboolean  columnmajor = r_columnmajor;
+        int             strips;
+        int             i;
+
+        if (columnmajor)
+            R_StartColumnMajorView();
+
         if (player->cheats & CF_NOCLIP)
-            V_FillRect(0, viewwindowx, viewwindowy, viewwidth, viewheight, 0);
+            R_FillView(0);
         else if (r_homindicator)
-            V_FillRect(0, viewwindowx, viewwindowy, viewwidth, viewheight,
-                ((gametic % 20) < 9 && !consoleactive && !menuactive && !paused ? 176 : 0));
+            R_FillView((gametic % 20) < 9 && !consoleactive && !menuactive && !paused ? 176 : 0);
 
-        // The head node is the last node output.
-        R_RenderBSPNode(numnodes - 1);
+        R_StartRenderThreads();
+        strips = MIN(BETWEEN(1, r_threads, MAXRENDERTHREADS), numrenderthreads);
+        renderingstrips = (strips > 1);
+
+        // Hand each thread a strip of the view, then render the first strip here
+        for (i = 1; i < strips; i++)
+        {
+            renderstrips[i].x1 = i * viewwidth / strips;
+            renderstrips[i].x2 = (i + 1) * viewwidth / strips - 1;
+            SDL_SemPost(renderstrips[i].start);
+        }
+
+        R_RenderStrip(0, viewwidth / strips - 1);
+
+        for (i = 1; i < strips; i++)
+            SDL_SemWait(renderstrips[i].done);
+
+        renderingstrips = false;
+
+        if (columnmajor)
+            R_FinishColumnMajorView();
 
-        R_DrawPlanes();
-        R_DrawMasked();
+        // draw the psprites on top of everything
+        if (r_playersprites && !inhelpscreens)
+            R_DrawPlayerSprites();
     }
 }
@@ -61,6 +61,10 @@ extern fixed_t          projectiony;
 
 extern int              validcount;
 
+// The columns of the view being rendered by the current thread.
+extern THREADLOCAL int  stripx1;
+extern THREADLOCAL int  stripx2;
+
 //
 // Lighting LUT.
 // Used for z-depth cuing per column/row,
@@ -107,33 +111,33 @@ extern fixed_t          fractionaltic;
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void (*colfunc)(void);
-extern void (*wallcolfunc)(void);
-extern void (*fbwallcolfunc)(void);
-extern void (*transcolfunc)(void);
-extern void (*basecolfunc)(void);
-extern void (*fuzzcolfunc)(void);
-extern void (*tlcolfunc)(void);
-extern void (*tl50colfunc)(void);
-extern void (*tl33colfunc)(void);
-extern void (*tlgreencolfunc)(void);
-extern void (*tlredcolfunc)(void);
-extern void (*tlredwhitecolfunc1)(void);
-extern void (*tlredwhitecolfunc2)(void);
-extern void (*tlredwhite50colfunc)(void);
-extern void (*tlbluecolfunc)(void);
-extern void (*tlgreen33colfunc)(void);
-extern void (*tlred33colfunc)(void);
-extern void (*tlblue33colfunc)(void);
-extern void (*redtobluecolfunc)(void);
-extern void (*tlredtoblue33colfunc)(void);
-extern void (*skycolfunc)(void);
-extern void (*redtogreencolfunc)(void);
-extern void (*tlredtogreen33colfunc)(void);
-extern void (*psprcolfunc)(void);
-extern void (*spanfunc)(void);
-extern void (*bloodsplatcolfunc)(void);
-extern void (*megaspherecolfunc)(void);
+extern THREADLOCAL void (*colfunc)(const column_context_t *);
+extern void (*wallcolfunc)(const column_context_t *);
+extern void (*fbwallcolfunc)(const column_context_t *);
+extern void (*transcolfunc)(const column_context_t *);
+extern void (*basecolfunc)(const column_context_t *);
+extern void (*fuzzcolfunc)(const column_context_t *);
+extern void (*tlcolfunc)(const column_context_t *);
+extern void (*tl50colfunc)(const column_context_t *);
+extern void (*tl33colfunc)(const column_context_t *);
+extern void (*tlgreencolfunc)(const column_context_t *);
+extern void (*tlredcolfunc)(const column_context_t *);
+extern void (*tlredwhitecolfunc1)(const column_context_t *);
+extern void (*tlredwhitecolfunc2)(const column_context_t *);
+extern void (*tlredwhite50colfunc)(const column_context_t *);
+extern void (*tlbluecolfunc)(const column_context_t *);
+extern void (*tlgreen33colfunc)(const column_context_t *);
+extern void (*tlred33colfunc)(const column_context_t *);
+extern void (*tlblue33colfunc)(const column_context_t *);
+extern void (*redtobluecolfunc)(const column_context_t *);
+extern void (*tlredtoblue33colfunc)(const column_context_t *);
+extern void (*skycolfunc)(const column_context_t *);
+extern void (*redtogreencolfunc)(const column_context_t *);
+extern void (*tlredtogreen33colfunc)(const column_context_t *);
+extern void (*psprcolfunc)(const column_context_t *);
+extern void (*spanfunc)(const span_context_t *);
+extern void (*bloodsplatcolfunc)(const column_context_t *);
+extern void (*megaspherecolfunc)(const column_context_t *);
 
 //
 // Utility functions.
@@ -48,11 +48,11 @@
 
 #define MAXVISPLANES    128                             // must be a power of 2
 
-static visplane_t       *visplanes[MAXVISPLANES];       // killough
-static visplane_t       *freetail;                      // killough
-static visplane_t       **freehead = &freetail;         // killough
-visplane_t              *floorplane;
-visplane_t              *ceilingplane;
+static THREADLOCAL visplane_t   *visplanes[MAXVISPLANES];       // killough
+static THREADLOCAL visplane_t   *freetail;                      // killough
+static THREADLOCAL visplane_t   **freehead;                     // killough
+THREADLOCAL visplane_t          *floorplane;
+THREADLOCAL visplane_t          *ceilingplane;
 
 // killough -- hash function for visplanes
 // Empirically verified to be fairly uniform:
@@ -60,25 +60,40 @@ visplane_t              *ceilingplane;
     (((unsigned int)(picnum) * 3 + (unsigned int)(lightlevel) + \
     (unsigned int)(height) * 7) & (MAXVISPLANES - 1))
 
-size_t                 maxopenings;
-int                    *openings;                       // dropoff overflow
-int                    *lastopening;                    // dropoff overflow
+THREADLOCAL size_t              maxopenings;
+THREADLOCAL int                 *openings;              // dropoff overflow
+THREADLOCAL int                 *lastopening;           // dropoff overflow
 
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
-int                     floorclip[SCREENWIDTH];         // dropoff overflow
-int                     ceilingclip[SCREENWIDTH];       // dropoff overflow
+THREADLOCAL int                 floorclip[SCREENWIDTH];     // dropoff overflow
+THREADLOCAL int                 ceilingclip[SCREENWIDTH];   // dropoff overflow
 
 // spanstart holds the start of a plane span
 // initialized to 0 at start
-static int              spanstart[SCREENHEIGHT];
+static THREADLOCAL int          spanstart[SCREENHEIGHT];
 
 // texture mapping
-static lighttable_t     **planezlight;
-static fixed_t          planeheight;
+static THREADLOCAL lighttable_t **planezlight;
+static THREADLOCAL fixed_t      planeheight;
+static THREADLOCAL byte         *planesource;
 
-static fixed_t          xoffs, yoffs;                   // killough 2/28/98: flat offsets
+static THREADLOCAL fixed_t      xoffs, yoffs;           // killough 2/28/98: flat offsets
+
+// The spans of a visplane are collected by row before being drawn, so the
+//  distance, steps and colormap of each row are only worked out once.
+typedef struct
+{
+    int                 x1;
+    int                 x2;
+    int                 next;                           // 1 + index of next span in row
+} planespan_t;
+
+static THREADLOCAL planespan_t  *planespans;
+static THREADLOCAL int          numplanespans;
+static THREADLOCAL int          maxplanespans;
+static THREADLOCAL int          planerows[SCREENHEIGHT];    // 1 + index of first span in row
 
 fixed_t                 yslope[SCREENHEIGHT];
 fixed_t                 distscale[SCREENWIDTH];
@@ -90,38 +105,75 @@ dboolean                r_liquid_swirl = r_liquid_swirl_default;
 //
 // Uses global vars:
 //  planeheight
-//  ds_source
+//  planesource
 //  viewx
 //  viewy
 //
+// Draws every span collected in row y of the current visplane.
+//
 // BASIC PRIMITIVE
 //
-static void R_MapPlane(int y, int x1, int x2)
+static void R_MapPlane(int y)
 {
-    fixed_t     distance;
-    int         dx, dy;
+    int                 i = planerows[y];
+    fixed_t             distance;
+    fixed_t             xfrac, yfrac;
+    int                 dy;
+    span_context_t      ds;
+
+    planerows[y] = 0;
 
     if (y == centery)
         return;
 
     distance = FixedMul(planeheight, yslope[y]);
 
-    dx = x1 - centerx;
     dy = ABS(centery - y);
-    ds_xstep = FixedMul(viewsin, planeheight) / dy;
-    ds_ystep = FixedMul(viewcos, planeheight) / dy;
+    ds.xstep = FixedMul(viewsin, planeheight) / dy;
+    ds.ystep = FixedMul(viewcos, planeheight) / dy;
 
-    ds_xfrac = viewx + xoffs + FixedMul(viewcos, distance) + dx * ds_xstep;
-    ds_yfrac = -viewy + yoffs - FixedMul(viewsin, distance) + dx * ds_ystep;
+    xfrac = viewx + xoffs + FixedMul(viewcos, distance);
+    yfrac = -viewy + yoffs - FixedMul(viewsin, distance);
 
-    ds_colormap = (fixedcolormap ? fixedcolormap :
+    ds.colormap = (fixedcolormap ? fixedcolormap :
         planezlight[BETWEEN(0, distance >> LIGHTZSHIFT, MAXLIGHTZ - 1)]);
 
-    ds_y = y;
-    ds_x1 = x1;
-    ds_x2 = x2;
+    ds.y = y;
+    ds.source = planesource;
+
+    do
+    {
+        const planespan_t   *span = &planespans[i - 1];
+        const int           dx = span->x1 - centerx;
+
+        ds.x1 = span->x1;
+        ds.x2 = span->x2;
+        ds.xfrac = xfrac + dx * ds.xstep;
+        ds.yfrac = yfrac + dx * ds.ystep;
 
-    spanfunc();
+        spanfunc(&ds);
+    } while ((i = planespans[i - 1].next));
+}
+
+//
+// R_AddPlaneSpan
+// Adds a span to row y of the current visplane, to be drawn by R_MapPlane.
+//
+static void R_AddPlaneSpan(int y, int x1, int x2)
+{
+    planespan_t *span;
+
+    if (numplanespans == maxplanespans)
+    {
+        maxplanespans = (maxplanespans ? maxplanespans * 2 : SCREENWIDTH);
+        planespans = realloc(planespans, maxplanespans * sizeof(*planespans));
+    }
+
+    span = &planespans[numplanespans++];
+    span->x1 = x1;
+    span->x2 = x2;
+    span->next = planerows[y];
+    planerows[y] = numplanespans;
 }
 
 //
@@ -133,12 +185,15 @@ void R_ClearPlanes(void)
     int i;
 
     // opening/clipping determination
-    for (i = 0; i < viewwidth; i++)
+    for (i = stripx1; i <= stripx2; i++)
     {
         floorclip[i] = viewheight;
         ceilingclip[i] = -1;
     }
 
+    if (!freehead)
+        freehead = &freetail;
+
     for (i = 0; i < MAXVISPLANES; i++)  // new code -- killough
         for (*freehead = visplanes[i], visplanes[i] = NULL; *freehead;)
             freehead = &(*freehead)->next;
@@ -262,6 +317,9 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop)
 static void R_MakeSpans(visplane_t *pl)
 {
     int x;
+    int y;
+    int miny = viewheight;
+    int maxy = -1;
 
     for (x = pl->minx; x <= pl->maxx + 1; ++x)
     {
@@ -270,15 +328,27 @@ static void R_MakeSpans(visplane_t *pl)
         unsigned short  t2 = pl->top[x];
         unsigned short  b2 = pl->bottom[x];
 
+        if (t1 < miny && t1 <= b1)
+            miny = t1;
+        if (b1 > maxy && t1 <= b1)
+            maxy = b1;
+
         for (; t1 < t2 && t1 <= b1; ++t1)
-            R_MapPlane(t1, spanstart[t1], x - 1);
+            R_AddPlaneSpan(t1, spanstart[t1], x - 1);
         for (; b1 > b2 && b1 >= t1; --b1)
-            R_MapPlane(b1, spanstart[b1], x - 1);
+            R_AddPlaneSpan(b1, spanstart[b1], x - 1);
         while (t2 < t1 && t2 <= b2)
             spanstart[t2++] = x;
         while (b2 > b1 && b2 >= t2)
             spanstart[b2--] = x;
     }
+
+    // draw the spans a row at a time
+    for (y = miny; y <= maxy; y++)
+        if (planerows[y])
+            R_MapPlane(y);
+
+    numplanespans = 0;
 }
 
 // Ripple Effect from Eternity Engine (r_ripple.cpp) by Simon Howard
@@ -293,8 +363,8 @@ static void R_MakeSpans(visplane_t *pl)
 // 1 cycle per 32 units (2 in 64)
 #define SWIRLFACTOR2    (8192 / 32)
 
-static byte     *normalflat;
-static byte     distortedflat[4096];
+static THREADLOCAL byte *normalflat;
+static THREADLOCAL byte distortedflat[4096];
 
 //
 // R_DistortedFlat
@@ -304,9 +374,9 @@ static byte     distortedflat[4096];
 //
 static byte *R_DistortedFlat(int flatnum)
 {
-    static int  lastflat = -1;
-    static int  swirltic = -1;
-    static int  offset[4096];
+    static THREADLOCAL int      lastflat = -1;
+    static THREADLOCAL int      swirltic = -1;
+    static THREADLOCAL int      offset[4096];
     int         i;
     int         leveltic = gametic;
 
@@ -375,9 +445,10 @@ void R_DrawPlanes(void)
                 // sky flat
                 if (picnum == skyflatnum || (picnum & PL_SKYFLAT))
                 {
-                    int         x;
-                    int         texture;
-                    angle_t     an, flip;
+                    int                 x;
+                    int                 texture;
+                    angle_t             an, flip;
+                    column_context_t    dc;
 
                     // killough 10/98: allow skies to come from sidedefs.
                     // Allows scrolling and/or animated skies, as well as
@@ -403,7 +474,7 @@ void R_DrawPlanes(void)
                         an += s->textureoffset;
 
                         // Vertical offset allows careful sky positioning.
-                        dc_texturemid = s->rowoffset - 28 * FRACUNIT;
+                        dc.texturemid = s->rowoffset - 28 * FRACUNIT;
 
                         // We sometimes flip the picture horizontally.
                         //
@@ -415,33 +486,33 @@ void R_DrawPlanes(void)
                     }
                     else        // Normal Doom sky, only one allowed per level
                     {
-                        dc_texturemid = skytexturemid;  // Default y-offset
+                        dc.texturemid = skytexturemid;  // Default y-offset
                         texture = skytexture;           // Default texture
                         flip = 0;                       // Doom flips it
                     }
 
-                    dc_iscale = pspriteiscale;
+                    dc.iscale = pspriteiscale;
 
                     // Sky is always drawn full bright,
                     //  i.e. colormaps[0] is used.
                     // Because of this hack, sky is not affected
                     //  by INVUL inverse mapping.
-                    dc_colormap = (fixedcolormap ? fixedcolormap : fullcolormap);
+                    dc.colormap = (fixedcolormap ? fixedcolormap : fullcolormap);
 
-                    dc_texheight = textureheight[texture] >> FRACBITS;
-                    dc_iscale = pspriteiscale;
+                    dc.texheight = textureheight[texture] >> FRACBITS;
+                    dc.iscale = pspriteiscale;
 
                     for (x = pl->minx; x <= pl->maxx; x++)
                     {
-                        dc_yl = pl->top[x];
-                        dc_yh = pl->bottom[x];
+                        dc.yl = pl->top[x];
+                        dc.yh = pl->bottom[x];
 
-                        if (dc_yl <= dc_yh)
+                        if (dc.yl <= dc.yh)
                         {
-                            dc_x = x;
-                            dc_source = R_GetColumn(texture,
+                            dc.x = x;
+                            dc.source = R_GetColumn(texture,
                                 ((an + xtoviewangle[x]) ^ flip) >> ANGLETOSKYSHIFT, false);
-                            skycolfunc();
+                            skycolfunc(&dc);
                         }
                     }
                 }
@@ -450,10 +521,9 @@ void R_DrawPlanes(void)
                     // regular flat
                     dboolean    liquid = isliquid[picnum];
                     dboolean    swirling = (liquid && r_liquid_swirl);
-                    int         lumpnum = firstflat + flattranslation[picnum];
 
-                    ds_source = (swirling ? R_DistortedFlat(picnum) :
-                        W_CacheLumpNum(lumpnum, PU_STATIC));
+                    planesource = (swirling ? R_DistortedFlat(picnum) :
+                        W_CacheLumpNum(firstflat + flattranslation[picnum], PU_CACHE));
 
                     xoffs = pl->xoffs;  // killough 2/28/98: Add offsets
                     yoffs = pl->yoffs;
@@ -468,9 +538,6 @@ void R_DrawPlanes(void)
                     pl->top[pl->minx - 1] = pl->top[pl->maxx + 1] = SHRT_MAX;
 
                     R_MakeSpans(pl);
-
-                    if (!swirling)
-                        W_ReleaseLumpNum(lumpnum);
                 }
             }
         }
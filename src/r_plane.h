@@ -45,15 +45,15 @@
 #define PL_SKYFLAT      0x80000000
 
 // Visplane related.
-extern  int     *lastopening;
+extern THREADLOCAL int      *lastopening;
 
-extern int      floorclip[];
-extern int      ceilingclip[];
+extern THREADLOCAL int      floorclip[];
+extern THREADLOCAL int      ceilingclip[];
 
 extern fixed_t  yslope[];
 extern fixed_t  distscale[];
 
-extern dboolean markceiling;
+extern THREADLOCAL dboolean markceiling;
 
 extern dboolean r_brightmaps;
 
@@ -45,59 +45,59 @@
 
 // killough 1/6/98: replaced globals with statics where appropriate
 
-static dboolean segtextured;            // True if any of the segs textures might be visible.
+static THREADLOCAL dboolean segtextured;    // True if any of the segs textures might be visible.
 
-static dboolean markfloor;              // False if the back side is the same plane.
-dboolean        markceiling;
+static THREADLOCAL dboolean markfloor;      // False if the back side is the same plane.
+THREADLOCAL dboolean        markceiling;
 
-static dboolean maskedtexture;
-static int      toptexture;
-static int      midtexture;
-static int      bottomtexture;
+static THREADLOCAL dboolean maskedtexture;
+static THREADLOCAL int      toptexture;
+static THREADLOCAL int      midtexture;
+static THREADLOCAL int      bottomtexture;
 
-static fixed_t  toptexheight;
-static fixed_t  midtexheight;
-static fixed_t  bottomtexheight;
+static THREADLOCAL fixed_t  toptexheight;
+static THREADLOCAL fixed_t  midtexheight;
+static THREADLOCAL fixed_t  bottomtexheight;
 
-static byte     *toptexfullbright;
-static byte     *midtexfullbright;
-static byte     *bottomtexfullbright;
+static THREADLOCAL byte     *toptexfullbright;
+static THREADLOCAL byte     *midtexfullbright;
+static THREADLOCAL byte     *bottomtexfullbright;
 
-angle_t         rw_normalangle;
-fixed_t         rw_distance;
+THREADLOCAL angle_t         rw_normalangle;
+THREADLOCAL fixed_t         rw_distance;
 
 //
 // regular wall
 //
-static int      rw_x;
-static int      rw_stopx;
-static angle_t  rw_centerangle;
-static fixed_t  rw_offset;
-static fixed_t  rw_scale;
-static fixed_t  rw_scalestep;
-static fixed_t  rw_midtexturemid;
-static fixed_t  rw_toptexturemid;
-static fixed_t  rw_bottomtexturemid;
+static THREADLOCAL int      rw_x;
+static THREADLOCAL int      rw_stopx;
+static THREADLOCAL angle_t  rw_centerangle;
+static THREADLOCAL fixed_t  rw_offset;
+static THREADLOCAL fixed_t  rw_scale;
+static THREADLOCAL fixed_t  rw_scalestep;
+static THREADLOCAL fixed_t  rw_midtexturemid;
+static THREADLOCAL fixed_t  rw_toptexturemid;
+static THREADLOCAL fixed_t  rw_bottomtexturemid;
 
-static int      worldtop;
-static int      worldbottom;
-static int      worldhigh;
-static int      worldlow;
+static THREADLOCAL int      worldtop;
+static THREADLOCAL int      worldbottom;
+static THREADLOCAL int      worldhigh;
+static THREADLOCAL int      worldlow;
 
-static int64_t  pixhigh;
-static int64_t  pixlow;
-static fixed_t  pixhighstep;
-static fixed_t  pixlowstep;
+static THREADLOCAL int64_t  pixhigh;
+static THREADLOCAL int64_t  pixlow;
+static THREADLOCAL fixed_t  pixhighstep;
+static THREADLOCAL fixed_t  pixlowstep;
 
-static int64_t  topfrac;
-static fixed_t  topstep;
+static THREADLOCAL int64_t  topfrac;
+static THREADLOCAL fixed_t  topstep;
 
-static int64_t  bottomfrac;
-static fixed_t  bottomstep;
+static THREADLOCAL int64_t  bottomfrac;
+static THREADLOCAL fixed_t  bottomstep;
 
-lighttable_t    **walllights;
+THREADLOCAL lighttable_t    **walllights;
 
-static int      *maskedtexturecol;      // dropoff overflow
+static THREADLOCAL int      *maskedtexturecol;  // dropoff overflow
 
 dboolean        r_brightmaps = r_brightmaps_default;
 
@@ -142,10 +142,10 @@ extern dboolean r_translucency;
 //   increasing the precision of various renderer variables, and,
 //   possibly, creating a noticable performance penalty.
 //
-static int      max_rwscale = 64 * FRACUNIT;
-static int      heightbits = 12;
-static int      heightunit = (1 << 12);
-static int      invhgtbits = 4;
+static THREADLOCAL int  max_rwscale = 64 * FRACUNIT;
+static THREADLOCAL int  heightbits = 12;
+static THREADLOCAL int  heightunit = (1 << 12);
+static THREADLOCAL int  invhgtbits = 4;
 
 typedef struct
 {
@@ -162,35 +162,29 @@ static const scale_values_t scale_values[9] =
 
 void R_FixWiggle(sector_t *sector)
 {
-    static int  lastheight = 0;
+    static THREADLOCAL int      lastheight = 0;
 
-    // disallow negative heights, force cache initialization
+    // disallow negative heights
     int         height = MAX(1, (sector->interpceilingheight - sector->interpfloorheight) >> FRACBITS);
 
     // early out?
     if (height != lastheight)
     {
         const scale_values_t    *svp;
+        int                     scaleindex = 0;
 
         lastheight = height;
 
-        // initialize, or handle moving sector
-        if (height != sector->cachedheight)
-        {
-            int scaleindex = 0;
-
-            sector->cachedheight = height;
-            height >>= 7;
+        // calculate adjustment
+        // (this isn't cached in the sector, as more than one strip of the
+        // view may be rendering it at once)
+        height >>= 7;
 
-            // calculate adjustment
-            while ((height >>= 1))
-                scaleindex++;
-
-            sector->scaleindex = scaleindex;
-        }
+        while ((height >>= 1))
+            scaleindex++;
 
         // fine-tune renderer for this wall
-        svp = &scale_values[sector->scaleindex];
+        svp = &scale_values[scaleindex];
         max_rwscale = svp->clamp;
         heightbits = svp->heightbits;
         heightunit = (1 << heightbits);
@@ -198,12 +192,12 @@ void R_FixWiggle(sector_t *sector)
     }
 }
 
-static void R_DrawMaskedColumn(column_t *column)
+static void R_DrawMaskedColumn(column_context_t *dc, column_t *column)
 {
     int         td;
     int         topdelta = -1;
     int         lastlength = 0;
-    fixed_t     texturemid = dc_texturemid;
+    fixed_t     texturemid = dc->texturemid;
 
     while ((td = column->topdelta) != 0xFF)
     {
@@ -215,16 +209,16 @@ static void R_DrawMaskedColumn(column_t *column)
         // calculate unclipped screen coordinates for post
         topscreen = sprtopscreen + spryscale * topdelta;
 
-        dc_yl = MAX((int)((topscreen + FRACUNIT - 1) >> FRACBITS), mceilingclip[dc_x] + 1);
-        dc_yh = MIN((int)((topscreen + spryscale * lastlength) >> FRACBITS),
-            mfloorclip[dc_x] - 1);
+        dc->yl = MAX((int)((topscreen + FRACUNIT - 1) >> FRACBITS), mceilingclip[dc->x] + 1);
+        dc->yh = MIN((int)((topscreen + spryscale * lastlength) >> FRACBITS),
+            mfloorclip[dc->x] - 1);
 
-        if (dc_yh < viewheight && dc_yl <= dc_yh)
+        if (dc->yh < viewheight && dc->yl <= dc->yh)
         {
-            dc_texturefrac = texturemid - (topdelta << FRACBITS)
-                + FixedMul((dc_yl - centery) << FRACBITS, dc_iscale);
-            dc_source = (byte *)column + 3;
-            colfunc();
+            dc->texturefrac = texturemid - (topdelta << FRACBITS)
+                + FixedMul((dc->yl - centery) << FRACBITS, dc->iscale);
+            dc->source = (byte *)column + 3;
+            colfunc(dc);
         }
 
         column = (column_t *)((byte *)column + lastlength + 4);
@@ -236,10 +230,11 @@ static void R_DrawMaskedColumn(column_t *column)
 //
 void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
 {
-    int         lightnum;
-    int         texnum;
-    fixed_t     texheight;
-    sector_t    tempsec;        // killough 4/13/98
+    int                 lightnum;
+    int                 texnum;
+    fixed_t             texheight;
+    sector_t            tempsec;        // killough 4/13/98
+    column_context_t    dc;
 
     // Calculate light table.
     // Use different light tables for horizontal / vertical.
@@ -273,36 +268,36 @@ void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
 
     // find positioning
     if (curline->linedef->flags & ML_DONTPEGBOTTOM)
-        dc_texturemid = MAX(frontsector->interpfloorheight, backsector->interpfloorheight)
+        dc.texturemid = MAX(frontsector->interpfloorheight, backsector->interpfloorheight)
             + texheight - viewz + curline->sidedef->rowoffset;
     else
-        dc_texturemid = MIN(frontsector->interpceilingheight, backsector->interpceilingheight)
+        dc.texturemid = MIN(frontsector->interpceilingheight, backsector->interpceilingheight)
             - viewz + curline->sidedef->rowoffset;
 
-    dc_colormap = fixedcolormap;
+    dc.colormap = fixedcolormap;
 
     // draw the columns
-    for (dc_x = x1; dc_x <= x2; ++dc_x, spryscale += rw_scalestep)
+    for (dc.x = x1; dc.x <= x2; ++dc.x, spryscale += rw_scalestep)
     {
         // calculate lighting
-        if (maskedtexturecol[dc_x] != INT_MAX)
+        if (maskedtexturecol[dc.x] != INT_MAX)
         {
             if (!fixedcolormap)
-                dc_colormap = walllights[BETWEEN(0, spryscale >> LIGHTSCALESHIFT,
+                dc.colormap = walllights[BETWEEN(0, spryscale >> LIGHTSCALESHIFT,
                     MAXLIGHTSCALE - 1)];
 
             // killough 3/2/98:
             //
             // This calculation used to overflow and cause crashes in Doom:
             //
-            // sprtopscreen = centeryfrac - FixedMul(dc_texturemid, spryscale);
+            // sprtopscreen = centeryfrac - FixedMul(dc.texturemid, spryscale);
             //
             // This code fixes it, by using double-precision intermediate
             // arithmetic and by skipping the drawing of 2s normals whose
             // mapping to screen coordinates is totally out of range:
             {
                 int64_t     t = ((int64_t)centeryfrac << FRACBITS)
-                                - (int64_t)dc_texturemid * spryscale;
+                                - (int64_t)dc.texturemid * spryscale;
 
                 if (t + (int64_t)texheight * spryscale < 0
                     || t > (int64_t)SCREENHEIGHT << FRACBITS * 2)
@@ -311,12 +306,12 @@ void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
                 sprtopscreen = (int64_t)(t >> FRACBITS);
             }
 
-            dc_iscale = 0xFFFFFFFFu / (unsigned int)spryscale;
+            dc.iscale = 0xFFFFFFFFu / (unsigned int)spryscale;
 
             // draw the texture
-            R_DrawMaskedColumn((column_t *)((byte *)R_GetColumn(texnum,
-                maskedtexturecol[dc_x], false) - 3));
-            maskedtexturecol[dc_x] = INT_MAX;   // dropoff overflow
+            R_DrawMaskedColumn(&dc, (column_t *)((byte *)R_GetColumn(texnum,
+                maskedtexturecol[dc.x], false) - 3));
+            maskedtexturecol[dc.x] = INT_MAX;   // dropoff overflow
         }
     }
 }
@@ -331,7 +326,8 @@ void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
 //
 void R_RenderSegLoop(void)
 {
-    fixed_t     texturecolumn;
+    fixed_t             texturecolumn;
+    column_context_t    dc;
 
     for (; rw_x < rw_stopx; ++rw_x)
     {
@@ -394,9 +390,9 @@ void R_RenderSegLoop(void)
 
             texturecolumn = (rw_offset - FixedMul(finetangent[angle], rw_distance)) >> FRACBITS;
 
-            dc_colormap = walllights[BETWEEN(0, rw_scale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1)];
-            dc_x = rw_x;
-            dc_iscale = 0xFFFFFFFFu / (unsigned int)rw_scale;
+            dc.colormap = walllights[BETWEEN(0, rw_scale >> LIGHTSCALESHIFT, MAXLIGHTSCALE - 1)];
+            dc.x = rw_x;
+            dc.iscale = 0xFFFFFFFFu / (unsigned int)rw_scale;
         }
 
         // draw the wall tiers
@@ -405,25 +401,26 @@ void R_RenderSegLoop(void)
             if (yl < viewheight && yh >= 0 && yh >= yl)
             {
                 // single sided line
-                dc_yl = yl;
-                dc_yh = yh;
+                dc.yl = yl;
+                dc.yh = yh;
 
                 // [BH] for "sparkle" hack
-                dc_topsparkle = false;
-                dc_bottomsparkle = (!bottomclipped && dc_yh > dc_yl
+                dc.topsparkle = false;
+                dc.bottomsparkle = (!bottomclipped && dc.yh > dc.yl
                     && rw_distance < (512 << FRACBITS));
 
-                dc_texturemid = rw_midtexturemid;
-                dc_source = R_GetColumn(midtexture, texturecolumn, true);
-                dc_texheight = midtexheight;
+                dc.texturemid = rw_midtexturemid;
+                dc.source = R_GetColumn(midtexture, texturecolumn, true);
+                dc.texheight = midtexheight;
+                dc.texpadheight = texturepadheight[midtexture];
 
                 // [BH] apply brightmap
-                dc_colormask = midtexfullbright;
+                dc.colormask = midtexfullbright;
 
-                if (dc_colormask && r_brightmaps && !fixedcolormap)
-                    fbwallcolfunc();
+                if (dc.colormask && r_brightmaps && !fixedcolormap)
+                    fbwallcolfunc(&dc);
                 else
-                    wallcolfunc();
+                    wallcolfunc(&dc);
             }
             ceilingclip[rw_x] = viewheight;
             floorclip[rw_x] = -1;
@@ -441,34 +438,35 @@ void R_RenderSegLoop(void)
                 if (mid >= floorclip[rw_x])
                 {
                     mid = floorclip[rw_x] - 1;
-                    dc_bottomsparkle = false;
+                    dc.bottomsparkle = false;
                 }
                 else
-                    dc_bottomsparkle = true;
+                    dc.bottomsparkle = true;
 
                 if (mid >= yl)
                 {
                     if (yl < viewheight && mid >= 0)
                     {
-                        dc_yl = yl;
-                        dc_yh = mid;
+                        dc.yl = yl;
+                        dc.yh = mid;
 
                         // [BH] for "sparkle" hack
-                        dc_topsparkle = false;
-                        dc_bottomsparkle = (dc_bottomsparkle && dc_yh > dc_yl
+                        dc.topsparkle = false;
+                        dc.bottomsparkle = (dc.bottomsparkle && dc.yh > dc.yl
                             && rw_distance < (512 << FRACBITS));
 
-                        dc_texturemid = rw_toptexturemid;
-                        dc_source = R_GetColumn(toptexture, texturecolumn, true);
-                        dc_texheight = toptexheight;
+                        dc.texturemid = rw_toptexturemid;
+                        dc.source = R_GetColumn(toptexture, texturecolumn, true);
+                        dc.texheight = toptexheight;
+                        dc.texpadheight = texturepadheight[toptexture];
 
                         // [BH] apply brightmap
-                        dc_colormask = toptexfullbright;
+                        dc.colormask = toptexfullbright;
 
-                        if (dc_colormask && r_brightmaps && !fixedcolormap)
-                            fbwallcolfunc();
+                        if (dc.colormask && r_brightmaps && !fixedcolormap)
+                            fbwallcolfunc(&dc);
                         else
-                            wallcolfunc();
+                            wallcolfunc(&dc);
                     }
                     ceilingclip[rw_x] = mid;
                 }
@@ -491,35 +489,36 @@ void R_RenderSegLoop(void)
                 if (mid <= ceilingclip[rw_x])
                 {
                     mid = ceilingclip[rw_x] + 1;
-                    dc_topsparkle = false;
+                    dc.topsparkle = false;
                 }
                 else
-                    dc_topsparkle = true;
+                    dc.topsparkle = true;
 
                 if (mid <= yh)
                 {
                     if (mid < viewheight && yh >= 0)
                     {
-                        dc_yl = mid;
-                        dc_yh = yh;
+                        dc.yl = mid;
+                        dc.yh = yh;
 
                         // [BH] for "sparkle" hack
-                        dc_topsparkle = (dc_topsparkle && dc_yh > dc_yl
+                        dc.topsparkle = (dc.topsparkle && dc.yh > dc.yl
                             && rw_distance < (128 << FRACBITS));
-                        dc_bottomsparkle = (!bottomclipped && dc_yh > dc_yl
+                        dc.bottomsparkle = (!bottomclipped && dc.yh > dc.yl
                             && rw_distance < (512 << FRACBITS));
 
-                        dc_texturemid = rw_bottomtexturemid;
-                        dc_source = R_GetColumn(bottomtexture, texturecolumn, true);
-                        dc_texheight = bottomtexheight;
+                        dc.texturemid = rw_bottomtexturemid;
+                        dc.source = R_GetColumn(bottomtexture, texturecolumn, true);
+                        dc.texheight = bottomtexheight;
+                        dc.texpadheight = texturepadheight[bottomtexture];
 
                         // [BH] apply brightmap
-                        dc_colormask = bottomtexfullbright;
+                        dc.colormask = bottomtexfullbright;
 
-                        if (dc_colormask && r_brightmaps && !fixedcolormap)
-                            fbwallcolfunc();
+                        if (dc.colormask && r_brightmaps && !fixedcolormap)
+                            fbwallcolfunc(&dc);
                         else
-                            wallcolfunc();
+                            wallcolfunc(&dc);
                     }
                     floorclip[rw_x] = mid;
                 }
@@ -609,8 +608,8 @@ void R_StoreWallRange(int start, int stop)
 
     // killough 1/6/98, 2/1/98: remove limit on openings
     {
-        extern int      *openings;              // dropoff overflow
-        extern size_t   maxopenings;
+        extern THREADLOCAL int      *openings;  // dropoff overflow
+        extern THREADLOCAL size_t   maxopenings;
         size_t          pos = lastopening - openings;
         size_t          need = (rw_stopx - start) * sizeof(*lastopening) + pos;
 
@@ -739,7 +738,7 @@ void R_StoreWallRange(int start, int stop)
         //
         // killough 4/7/98: make doorclosed external variable
         {
-            extern dboolean     doorclosed;
+            extern THREADLOCAL dboolean doorclosed;
 
             if (doorclosed || backsector->interpceilingheight <= frontsector->interpfloorheight)
             {
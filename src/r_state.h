@@ -50,6 +50,7 @@
 
 // needed for texture pegging
 extern fixed_t          *textureheight;
+extern int              *texturepadheight;
 
 extern byte             **texturefullbright;
 
@@ -136,9 +137,9 @@ extern angle_t          clipangle;
 extern int              viewangletox[FINEANGLES / 2];
 extern angle_t          xtoviewangle[SCREENWIDTH + 1];
 
-extern angle_t          rw_normalangle;
+extern THREADLOCAL angle_t     rw_normalangle;
 
-extern visplane_t       *floorplane;
-extern visplane_t       *ceilingplane;
+extern THREADLOCAL visplane_t  *floorplane;
+extern THREADLOCAL visplane_t  *ceilingplane;
 
 #endif
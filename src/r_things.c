@@ -59,7 +59,7 @@ fixed_t                         pspritexscale;
 fixed_t                         pspriteyscale;
 fixed_t                         pspriteiscale;
 
-static lighttable_t             **spritelights;         // killough 1/25/98 made static
+static THREADLOCAL lighttable_t **spritelights;         // killough 1/25/98 made static
 
 // constant arrays
 //  used for psprite clipping and initializing clipping
@@ -83,7 +83,6 @@ dboolean                        r_liquid_clipsprites = r_liquid_clipsprites_defa
 
 dboolean                        r_playersprites = r_playersprites_default;
 
-extern dboolean                 inhelpscreens;
 extern dboolean                 r_translucency;
 extern dboolean                 dehacked;
 extern dboolean                 r_shadows;
@@ -299,11 +298,11 @@ static void R_InitSpriteDefs(const char *const *namelist)
 // GAME FUNCTIONS
 //
 
-static vissprite_t      *vissprites[NUMVISSPRITETYPES];
-static vissprite_t      **vissprite_ptrs;
-static int              num_vissprite[NUMVISSPRITETYPES];
-static int              num_vissprite_alloc[NUMVISSPRITETYPES];
-static int              num_vissprite_ptrs;
+static THREADLOCAL vissprite_t  *vissprites[NUMVISSPRITETYPES];
+static THREADLOCAL vissprite_t  **vissprite_ptrs;
+static THREADLOCAL int          num_vissprite[NUMVISSPRITETYPES];
+static THREADLOCAL int          num_vissprite_alloc[NUMVISSPRITETYPES];
+static THREADLOCAL int          num_vissprite_ptrs;
 
 //
 // R_InitSprites
@@ -352,14 +351,14 @@ vissprite_t *R_NewVisSprite(visspritetype_t type)
 // Masked means: partly transparent, i.e. stored
 //  in posts/runs of opaque pixels.
 //
-int     *mfloorclip;
-int     *mceilingclip;
+THREADLOCAL int     *mfloorclip;
+THREADLOCAL int     *mceilingclip;
 
-fixed_t spryscale;
-int64_t sprtopscreen;
-int64_t shift;
+THREADLOCAL fixed_t spryscale;
+THREADLOCAL int64_t sprtopscreen;
+THREADLOCAL int64_t shift;
 
-static void R_DrawMaskedSpriteColumn(column_t *column)
+static void R_DrawMaskedSpriteColumn(column_context_t *dc, column_t *column)
 {
     byte        topdelta;
 
@@ -370,41 +369,41 @@ static void R_DrawMaskedSpriteColumn(column_t *column)
         // calculate unclipped screen coordinates for post
         int64_t topscreen = sprtopscreen + spryscale * topdelta + 1;
 
-        dc_yl = MAX((int)((topscreen + FRACUNIT) >> FRACBITS), mceilingclip[dc_x] + 1);
-        dc_yh = MIN((int)((topscreen + spryscale * length) >> FRACBITS), mfloorclip[dc_x] - 1);
+        dc->yl = MAX((int)((topscreen + FRACUNIT) >> FRACBITS), mceilingclip[dc->x] + 1);
+        dc->yh = MIN((int)((topscreen + spryscale * length) >> FRACBITS), mfloorclip[dc->x] - 1);
 
-        if (dc_baseclip != -1)
-            dc_yh = MIN(dc_baseclip, dc_yh);
+        if (dc->baseclip != -1)
+            dc->yh = MIN(dc->baseclip, dc->yh);
 
-        dc_texturefrac = dc_texturemid - (topdelta << FRACBITS)
-            + FixedMul((dc_yl - centery) << FRACBITS, dc_iscale);
+        dc->texturefrac = dc->texturemid - (topdelta << FRACBITS)
+            + FixedMul((dc->yl - centery) << FRACBITS, dc->iscale);
 
-        if (dc_texturefrac < 0)
+        if (dc->texturefrac < 0)
         {
-            int cnt = (FixedDiv(-dc_texturefrac, dc_iscale) + FRACUNIT - 1) >> FRACBITS;
+            int cnt = (FixedDiv(-dc->texturefrac, dc->iscale) + FRACUNIT - 1) >> FRACBITS;
 
-            dc_yl += cnt;
-            dc_texturefrac += cnt * dc_iscale;
+            dc->yl += cnt;
+            dc->texturefrac += cnt * dc->iscale;
         }
 
         {
-            const fixed_t       endfrac = dc_texturefrac + (dc_yh - dc_yl) * dc_iscale;
+            const fixed_t       endfrac = dc->texturefrac + (dc->yh - dc->yl) * dc->iscale;
             const fixed_t       maxfrac = length << FRACBITS;
 
             if (endfrac >= maxfrac)
-                dc_yh -= (FixedDiv(endfrac - maxfrac - 1, dc_iscale) + FRACUNIT - 1) >> FRACBITS;
+                dc->yh -= (FixedDiv(endfrac - maxfrac - 1, dc->iscale) + FRACUNIT - 1) >> FRACBITS;
         }
 
-        if (dc_yl <= dc_yh && dc_yh < viewheight)
+        if (dc->yl <= dc->yh && dc->yh < viewheight)
         {
-            dc_source = (byte *)column + 3;
-            colfunc();
+            dc->source = (byte *)column + 3;
+            colfunc(dc);
         }
         column = (column_t *)((byte *)column + length + 4);
     }
 }
 
-static void R_DrawMaskedBloodSplatColumn(column_t *column)
+static void R_DrawMaskedBloodSplatColumn(column_context_t *dc, column_t *column)
 {
     byte        topdelta;
 
@@ -415,16 +414,16 @@ static void R_DrawMaskedBloodSplatColumn(column_t *column)
         // calculate unclipped screen coordinates for post
         int64_t topscreen = sprtopscreen + spryscale * topdelta;
 
-        dc_yl = MAX((int)(topscreen >> FRACBITS) + 1, mceilingclip[dc_x] + 1);
-        dc_yh = MIN((int)((topscreen + spryscale * length) >> FRACBITS), mfloorclip[dc_x] - 1);
+        dc->yl = MAX((int)(topscreen >> FRACBITS) + 1, mceilingclip[dc->x] + 1);
+        dc->yh = MIN((int)((topscreen + spryscale * length) >> FRACBITS), mfloorclip[dc->x] - 1);
 
-        if (dc_yl <= dc_yh && dc_yh < viewheight)
-            colfunc();
+        if (dc->yl <= dc->yh && dc->yh < viewheight)
+            colfunc(dc);
         column = (column_t *)((byte *)column + length + 4);
     }
 }
 
-static void R_DrawMaskedShadowColumn(column_t *column)
+static void R_DrawMaskedShadowColumn(column_context_t *dc, column_t *column)
 {
     byte        topdelta;
 
@@ -435,17 +434,19 @@ static void R_DrawMaskedShadowColumn(column_t *column)
         // calculate unclipped screen coordinates for post
         int64_t topscreen = sprtopscreen + spryscale * topdelta;
 
-        dc_yl = MAX((int)(((topscreen >> FRACBITS) + 1) / 10 + shift), mceilingclip[dc_x] + 1);
-        dc_yh = MIN((int)(((topscreen + spryscale * length) >> FRACBITS) / 10 + shift),
-            mfloorclip[dc_x] - 1);
+        dc->yl = MAX((int)(((topscreen >> FRACBITS) + 1) / 10 + shift), mceilingclip[dc->x] + 1);
+        dc->yh = MIN((int)(((topscreen + spryscale * length) >> FRACBITS) / 10 + shift),
+            mfloorclip[dc->x] - 1);
 
-        if (dc_yl <= dc_yh && dc_yh < viewheight)
-            colfunc();
+        if (dc->yl <= dc->yh && dc->yh < viewheight)
+            colfunc(dc);
         column = (column_t *)((byte *)column + length + 4);
     }
 }
 
-int     fuzzpos;
+// Each render strip uses its own part of fuzztable so that threads never write
+// to the same entries.
+THREADLOCAL int     fuzzpos;
 
 //
 // R_DrawVisSprite
@@ -453,25 +454,26 @@ int     fuzzpos;
 //
 void R_DrawVisSprite(vissprite_t *vis)
 {
-    fixed_t     frac = vis->startfrac;
-    fixed_t     xiscale = vis->xiscale;
-    fixed_t     x2 = vis->x2;
-    patch_t     *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    fixed_t             frac = vis->startfrac;
+    fixed_t             xiscale = vis->xiscale;
+    fixed_t             x2 = vis->x2;
+    patch_t             *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    column_context_t    dc;
 
-    dc_colormap = vis->colormap;
+    dc.colormap = vis->colormap;
     colfunc = vis->colfunc;
 
-    dc_iscale = ABS(xiscale);
-    dc_texturemid = vis->texturemid;
+    dc.iscale = ABS(xiscale);
+    dc.texturemid = vis->texturemid;
     if (vis->mobjflags & MF_TRANSLATION)
     {
         colfunc = transcolfunc;
-        dc_translation = translationtables - 256
+        dc.translation = translationtables - 256
             + ((vis->mobjflags & MF_TRANSLATION) >> (MF_TRANSSHIFT - 8));
     }
 
     spryscale = vis->scale;
-    sprtopscreen = centeryfrac - FixedMul(dc_texturemid, spryscale);
+    sprtopscreen = centeryfrac - FixedMul(dc.texturemid, spryscale);
 
     if (viewplayer->fixedcolormap == INVERSECOLORMAP && r_translucency)
     {
@@ -488,15 +490,15 @@ void R_DrawVisSprite(vissprite_t *vis)
     }
 
     if (vis->footclip)
-        dc_baseclip = ((int)sprtopscreen + FixedMul(SHORT(patch->height) << FRACBITS, spryscale)
+        dc.baseclip = ((int)sprtopscreen + FixedMul(SHORT(patch->height) << FRACBITS, spryscale)
             - FixedMul(vis->footclip, spryscale)) >> FRACBITS;
     else
-        dc_baseclip = -1;
+        dc.baseclip = -1;
 
-    fuzzpos = 0;
+    fuzzpos = stripx1 * viewheight;
 
-    for (dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
-        R_DrawMaskedSpriteColumn((column_t *)((byte *)patch
+    for (dc.x = vis->x1; dc.x <= x2; dc.x++, frac += xiscale)
+        R_DrawMaskedSpriteColumn(&dc, (column_t *)((byte *)patch
             + LONG(patch->columnofs[frac >> FRACBITS])));
 
     colfunc = basecolfunc;
@@ -504,22 +506,24 @@ void R_DrawVisSprite(vissprite_t *vis)
 
 void R_DrawBloodSplatVisSprite(vissprite_t *vis)
 {
-    fixed_t     frac = vis->startfrac;
-    fixed_t     xiscale = vis->xiscale;
-    fixed_t     x2 = vis->x2;
-    patch_t     *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    fixed_t             frac = vis->startfrac;
+    fixed_t             xiscale = vis->xiscale;
+    fixed_t             x2 = vis->x2;
+    patch_t             *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    column_context_t    dc;
 
     colfunc = vis->colfunc;
 
-    dc_blood = tinttab75 + (vis->colormap[vis->blood] << 8);
+    dc.blood = tinttab75 + (vis->colormap[vis->blood] << 8);
+    dc.baseclip = -1;
 
     spryscale = vis->scale;
     sprtopscreen = centeryfrac - FixedMul(vis->texturemid, spryscale);
 
-    fuzzpos = 0;
+    fuzzpos = stripx1 * viewheight;
 
-    for (dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
-        R_DrawMaskedBloodSplatColumn((column_t *)((byte *)patch
+    for (dc.x = vis->x1; dc.x <= x2; dc.x++, frac += xiscale)
+        R_DrawMaskedBloodSplatColumn(&dc, (column_t *)((byte *)patch
             + LONG(patch->columnofs[frac >> FRACBITS])));
 
     colfunc = basecolfunc;
@@ -527,10 +531,11 @@ void R_DrawBloodSplatVisSprite(vissprite_t *vis)
 
 void R_DrawShadowVisSprite(vissprite_t *vis)
 {
-    fixed_t     frac = vis->startfrac;
-    fixed_t     xiscale = vis->xiscale;
-    fixed_t     x2 = vis->x2;
-    patch_t     *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    fixed_t             frac = vis->startfrac;
+    fixed_t             xiscale = vis->xiscale;
+    fixed_t             x2 = vis->x2;
+    patch_t             *patch = W_CacheLumpNum(vis->patch + firstspritelump, PU_CACHE);
+    column_context_t    dc;
 
     colfunc = vis->colfunc;
 
@@ -538,8 +543,8 @@ void R_DrawShadowVisSprite(vissprite_t *vis)
     sprtopscreen = centeryfrac - FixedMul(vis->texturemid, spryscale);
     shift = (sprtopscreen * 9 / 10) >> FRACBITS;
 
-    for (dc_x = vis->x1; dc_x <= x2; dc_x++, frac += xiscale)
-        R_DrawMaskedShadowColumn((column_t *)((byte *)patch
+    for (dc.x = vis->x1; dc.x <= x2; dc.x++, frac += xiscale)
+        R_DrawMaskedShadowColumn(&dc, (column_t *)((byte *)patch
             + LONG(patch->columnofs[frac >> FRACBITS])));
 
     colfunc = basecolfunc;
@@ -664,13 +669,13 @@ void R_ProjectSprite(mobj_t *thing)
     x1 = (centerxfrac + FRACUNIT / 2 + FixedMul(tx, xscale)) >> FRACBITS;
 
     // off the right side?
-    if (x1 > viewwidth)
+    if (x1 > stripx2)
         return;
 
     x2 = ((centerxfrac + FRACUNIT / 2 + FixedMul(tx + spritewidth[lump], xscale)) >> FRACBITS) - 1;
 
     // off the left side
-    if (x2 < 0)
+    if (x2 < stripx1)
         return;
 
     gzt = fz + spritetopoffset[lump];
@@ -739,8 +744,8 @@ void R_ProjectSprite(mobj_t *thing)
         vis->texturemid = gzt - viewz;
     }
 
-    vis->x1 = MAX(0, x1);
-    vis->x2 = MIN(x2, viewwidth - 1);
+    vis->x1 = MAX(stripx1, x1);
+    vis->x2 = MIN(x2, stripx2);
 
     if (flip)
     {
@@ -823,13 +828,13 @@ void R_ProjectBloodSplat(mobj_t *thing)
     x1 = (centerxfrac + FRACUNIT / 2 + FixedMul(tx, xscale)) >> FRACBITS;
 
     // off the right side?
-    if (x1 > viewwidth)
+    if (x1 > stripx2)
         return;
 
     x2 = ((centerxfrac + FRACUNIT / 2 + FixedMul(tx + spritewidth[lump], xscale)) >> FRACBITS) - 1;
 
     // off the left side
-    if (x2 < 0)
+    if (x2 < stripx1)
         return;
 
     gzt = fz + spritetopoffset[lump];
@@ -855,8 +860,8 @@ void R_ProjectBloodSplat(mobj_t *thing)
 
     vis->texturemid = gzt - viewz;
 
-    vis->x1 = MAX(0, x1);
-    vis->x2 = MIN(x2, viewwidth - 1);
+    vis->x1 = MAX(stripx1, x1);
+    vis->x2 = MIN(x2, stripx2);
 
     if (flip)
     {
@@ -957,13 +962,13 @@ void R_ProjectShadow(mobj_t *thing)
     x1 = (centerxfrac + FRACUNIT / 2 + FixedMul(tx, xscale)) >> FRACBITS;
 
     // off the right side?
-    if (x1 > viewwidth)
+    if (x1 > stripx2)
         return;
 
     x2 = ((centerxfrac + FRACUNIT / 2 + FixedMul(tx + spritewidth[lump], xscale)) >> FRACBITS) - 1;
 
     // off the left side
-    if (x2 < 0)
+    if (x2 < stripx1)
         return;
 
     // store information in a vissprite
@@ -981,8 +986,8 @@ void R_ProjectShadow(mobj_t *thing)
     vis->colfunc = thing->colfunc;
     vis->texturemid = fz - viewz;
 
-    vis->x1 = MAX(0, x1);
-    vis->x2 = MIN(x2, viewwidth - 1);
+    vis->x1 = MAX(stripx1, x1);
+    vis->x2 = MIN(x2, stripx2);
 
     if (flip)
     {
@@ -1108,7 +1113,7 @@ static void R_DrawPSprite(pspdef_t *psp, dboolean invisibility)
             vis->colfunc = R_DrawSuperShotgunColumn;
         else
         {
-            void (*colfuncs[])(void) =
+            void (*colfuncs[])(const column_context_t *) =
             {
                 /* n/a      */ NULL,
                 /* SPR_SHTG */ basecolfunc,
@@ -1195,7 +1200,7 @@ static void R_DrawPSprite(pspdef_t *psp, dboolean invisibility)
 //
 // R_DrawPlayerSprites
 //
-static void R_DrawPlayerSprites(void)
+void R_DrawPlayerSprites(void)
 {
     int         i;
     int         invisibility = viewplayer->powers[pw_invisibility];
@@ -1569,8 +1574,4 @@ void R_DrawMasked(void)
     for (ds = ds_p; ds-- > drawsegs;)
         if (ds->maskedtexturecol)
             R_RenderMaskedSegRange(ds, ds->x1, ds->x2);
-
-    // draw the psprites on top of everything
-    if (r_playersprites && !inhelpscreens)
-        R_DrawPlayerSprites();
 }
@@ -53,10 +53,10 @@ extern int      negonearray[SCREENWIDTH];
 extern int      screenheightarray[SCREENWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern int      *mfloorclip;
-extern int      *mceilingclip;
-extern fixed_t  spryscale;
-extern int64_t  sprtopscreen;
+extern THREADLOCAL int      *mfloorclip;
+extern THREADLOCAL int      *mceilingclip;
+extern THREADLOCAL fixed_t  spryscale;
+extern THREADLOCAL int64_t  sprtopscreen;
 
 extern fixed_t  pspritexscale;
 extern fixed_t  pspriteyscale;
@@ -70,6 +70,7 @@ void R_DrawSprites(void);
 void R_InitSprites(char **namelist);
 void R_ClearSprites(void);
 void R_DrawMasked(void);
+void R_DrawPlayerSprites(void);
 
 void R_ProjectSprite(mobj_t *thing);
 void R_ProjectBloodSplat(mobj_t *thing);
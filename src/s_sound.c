@@ -157,6 +157,12 @@ void S_Init(int sfxvol, int musicvol)
         nomusic = true;
         nosfx = true;
     }
+    else if (benchmark)
+    {
+        nosound = true;
+        nomusic = true;
+        nosfx = true;
+    }
     if (M_CheckParm("-nomusic") > 0)
     {
         C_Output("Found -NOMUSIC parameter on command-line. Music has been disabled.");
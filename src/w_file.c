@@ -37,12 +37,15 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 
+#include "doomdef.h"
 #include "doomtype.h"
 #include "m_argv.h"
 #include "w_file.h"
 
 extern wad_file_class_t stdc_wad_file;
+extern wad_file_class_t zip_wad_file;
 
 #if defined(WIN32)
 extern wad_file_class_t win32_wad_file;
@@ -63,11 +66,33 @@ static wad_file_class_t *wad_file_classes[] =
     &stdc_wad_file,
 };
 
+static dboolean HasExtension(char *path, char *ext)
+{
+    size_t      len = strlen(path);
+
+    return (len > 4 && path[len - 4] == '.' && !strcasecmp(path + len - 3, ext));
+}
+
+dboolean W_IsZipFile(char *path)
+{
+    return (HasExtension(path, "zip") || HasExtension(path, "pk3"));
+}
+
+dboolean W_IsWADFile(char *path)
+{
+    return HasExtension(path, "wad");
+}
+
 wad_file_t *W_OpenFile(char *path)
 {
     wad_file_t  *result;
     int         i;
 
+    // Zip files are always read through their own class, which decompresses
+    // their lumps as they're needed.
+    if (W_IsZipFile(path))
+        return zip_wad_file.OpenFile(path);
+
     //!
     // Use the OS's virtual memory subsystem to map WAD files
     // directly into memory.
@@ -98,3 +123,20 @@ size_t W_Read(wad_file_t *wad, unsigned int offset, void *buffer, size_t buffer_
 {
     return wad->file_class->Read(wad, offset, buffer, buffer_len);
 }
+
+void W_Advise(wad_file_t *wad, unsigned int offset, size_t length, dboolean willneed)
+{
+    if (wad->mapped && wad->file_class->Advise)
+        wad->file_class->Advise(wad, offset, length, willneed);
+}
+
+void *W_CacheLump(wad_file_t *wad, unsigned int offset, size_t length, int tag)
+{
+    return (wad->file_class->CacheLump ? wad->file_class->CacheLump(wad, offset, length, tag) : NULL);
+}
+
+void W_ReleaseLump(wad_file_t *wad, unsigned int offset)
+{
+    if (wad->file_class->ReleaseLump)
+        wad->file_class->ReleaseLump(wad, offset);
+}
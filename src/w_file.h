@@ -55,6 +55,20 @@ typedef struct
     // Read data from the specified position in the file into the
     // provided buffer.  Returns the number of bytes read.
     size_t (*Read)(wad_file_t *file, unsigned int offset, void *buffer, size_t buffer_len);
+
+    // Tell the OS that the data at the specified position in a mapped file
+    // will be needed soon, or won't be. NULL if the class can't.
+    void (*Advise)(wad_file_t *file, unsigned int offset, size_t length, dboolean willneed);
+
+    // Return the lump at the specified position in a file that keeps its
+    // own cache of lumps, with its zone tag changed to the specified tag.
+    // NULL if the class can't, or won't keep that lump.
+    void *(*CacheLump)(wad_file_t *file, unsigned int offset, size_t length, int tag);
+
+    // Change the zone tag of the lump at the specified position back to
+    // PU_CACHE, if it's in the file's own cache. NULL if the class has no
+    // cache.
+    void (*ReleaseLump)(wad_file_t *file, unsigned int offset);
 } wad_file_class_t;
 
 struct _wad_file_s
@@ -76,6 +90,12 @@ struct _wad_file_s
     int                 type;
 };
 
+// Returns true if the file is a zip file, from its extension.
+dboolean W_IsZipFile(char *path);
+
+// Returns true if the file is a WAD file, from its extension.
+dboolean W_IsWADFile(char *path);
+
 // Open the specified file. Returns a pointer to a new wad_file_t
 // handle for the WAD file, or NULL if it could not be opened.
 wad_file_t *W_OpenFile(char *path);
@@ -88,4 +108,17 @@ void W_CloseFile(wad_file_t *wad);
 // Returns the number of bytes read.
 size_t W_Read(wad_file_t *wad, unsigned int offset, void *buffer, size_t buffer_len);
 
+// Tell the OS that the specified data in a mapped WAD file will be needed
+// soon, or won't be. Does nothing if the file isn't mapped.
+void W_Advise(wad_file_t *wad, unsigned int offset, size_t length, dboolean willneed);
+
+// Return the lump at the specified position from the file's own cache, with
+// its zone tag changed to the specified tag. Returns NULL if the file doesn't
+// keep one, in which case the lump must be read with W_Read().
+void *W_CacheLump(wad_file_t *wad, unsigned int offset, size_t length, int tag);
+
+// Let the lump at the specified position in the file's own cache be freed
+// again. Does nothing if the file doesn't keep one.
+void W_ReleaseLump(wad_file_t *wad, unsigned int offset);
+
 #endif
@@ -58,26 +58,13 @@ extern wad_file_class_t posix_wad_file;
 static void MapFile(posix_wad_file_t *wad)
 {
     void        *result;
-    int         protection;
-    int         flags;
 
-    // Mapped area can be read and written to.  Ideally
-    // this should be read-only, as none of the Doom code should 
-    // change the WAD files after being read.  However, there may
-    // be code lurking in the source that does.
+    // The mapped area is read-only, as none of the DOOM code changes the data
+    // of lumps. Anything that needs to change a lump reads it into a copy of
+    // its own with W_ReadLump() instead.
+    result = mmap(NULL, wad->wad.length, PROT_READ, MAP_PRIVATE, wad->handle, 0);
 
-    protection = PROT_READ|PROT_WRITE;
-
-    // Writes to the mapped area result in private changes that are
-    // *not* written to disk.
-
-    flags = MAP_PRIVATE;
-
-    result = mmap(NULL, wad->wad.length,
-                  protection, flags, 
-                  wad->handle, 0);
-
-    wad->wad.mapped = result;
+    wad->wad.mapped = (result == MAP_FAILED ? NULL : result);
 }
 
 unsigned int GetFileLength(int handle)
@@ -116,6 +103,8 @@ static void W_POSIX_CloseFile(wad_file_t *wad)
     posix_wad = (posix_wad_file_t *) wad;
 
     // If mapped, unmap it.
+    if (posix_wad->wad.mapped)
+        munmap(posix_wad->wad.mapped, posix_wad->wad.length);
 
     // Close the file
     close(posix_wad->handle);
@@ -160,12 +149,34 @@ size_t W_POSIX_Read(wad_file_t *wad, unsigned int offset, void *buffer, size_t b
     return bytes_read;
 }
 
+// Tell the kernel to read the pages of the specified part of the mapped file
+// ahead of them being used, or that they can be dropped.
+static void W_POSIX_Advise(wad_file_t *wad, unsigned int offset, size_t length, dboolean willneed)
+{
+    static long         pagesize;
+    unsigned int        start;
+
+    if (!pagesize)
+        pagesize = sysconf(_SC_PAGESIZE);
+
+    // the address given to madvise() must be page-aligned
+    start = offset - offset % pagesize;
+
+    if (offset + length > wad->length)
+        length = wad->length - offset;
+
+    madvise(wad->mapped + start, length + offset - start,
+        (willneed ? MADV_WILLNEED : MADV_DONTNEED));
+}
 
 wad_file_class_t posix_wad_file = 
 {
     W_POSIX_OpenFile,
     W_POSIX_CloseFile,
     W_POSIX_Read,
+    W_POSIX_Advise,
+    NULL,
+    NULL
 };
 
 #endif
@@ -0,0 +1,983 @@
+/*
+========================================================================
+
+                               DOOM RETRO
+         The classic, refined DOOM source port. For Windows PC.
+
+========================================================================
+
+  Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+  Copyright (C) 2013-2015 Brad Harding.
+
+  DOOM RETRO is a fork of CHOCOLATE DOOM by Simon Howard.
+  For a complete list of credits, see the accompanying AUTHORS file.
+
+  This file is part of DOOM RETRO.
+
+  DOOM RETRO is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  DOOM RETRO is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DOOM RETRO. If not, see <http://www.gnu.org/licenses/>.
+
+  DOOM is a registered trademark of id Software LLC, a ZeniMax Media
+  company, in the US and/or other countries and is used without
+  permission. All other trademarks are the property of their respective
+  holders. DOOM RETRO is in no way affiliated with nor endorsed by
+  id Software LLC.
+
+========================================================================
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "c_console.h"
+#include "doomdef.h"
+#include "i_swap.h"
+#include "m_config.h"
+#include "m_misc.h"
+#include "w_file.h"
+#include "z_zone.h"
+
+//
+// Zip files are presented to W_AddFile() as if they were PWADs. The header
+// and directory of this "virtual WAD" are built when the file is opened,
+// followed by the lumps, which are only decompressed when they're read.
+// Entries in the flats and sprites folders are put between FF_START/FF_END
+// and SS_START/SS_END markers so they're merged like those in a PWAD.
+//
+
+#define ZIP_LOCALHEADER         0x04034b50
+#define ZIP_CENTRALHEADER       0x02014b50
+#define ZIP_ENDOFCENTRALDIR     0x06054b50
+
+#define ZIP_STORED              0
+#define ZIP_DEFLATED            8
+
+#define ZIP_MAXCOMMENT          65535
+
+typedef enum
+{
+    ns_global,
+    ns_flats,
+    ns_sprites
+} zipnamespace_t;
+
+typedef struct zipentry_s
+{
+    char                name[8];
+
+    // where the entry's local header is in the zip file
+    unsigned int        offset;
+
+    unsigned int        compressedsize;
+    unsigned int        size;
+    int                 method;
+
+    // where the lump is in the virtual WAD
+    unsigned int        position;
+
+    // the decompressed lump, if it's in the cache
+    byte                *cache;
+    dboolean            cached;
+
+    // the zone tag of the cached lump, which isn't freed unless it's PU_CACHE
+    int                 tag;
+    struct zipentry_s   *prev;
+    struct zipentry_s   *next;
+} zipentry_t;
+
+typedef struct
+{
+    wad_file_t          wad;
+    FILE                *fstream;
+    zipentry_t          *entries;
+    int                 numentries;
+
+    // the header and directory of the virtual WAD
+    byte                *directory;
+    unsigned int        directorysize;
+} zip_wad_file_t;
+
+extern wad_file_class_t zip_wad_file;
+
+// The amount of memory, in megabytes, used to keep decompressed lumps
+int                     zipcachesize = zipcachesize_default;
+
+// The decompressed lumps of all zip files, most recently used first. These
+// are the only copies of them, as W_CacheLumpNum() returns them directly.
+static zipentry_t       *cachehead;
+static zipentry_t       *cachetail;
+static size_t           cachedbytes;
+
+static unsigned int ReadShort(byte *p)
+{
+    return (p[0] | (p[1] << 8));
+}
+
+static unsigned int ReadLong(byte *p)
+{
+    return (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24));
+}
+
+//
+// INFLATE
+// Decompresses a raw deflate stream (RFC 1951), reading it from the zip file
+//  a buffer at a time.
+//
+
+#define MAXBITS                 15
+#define MAXLCODES               288
+#define MAXDCODES               30
+#define INFLATEBUFFERSIZE       16384
+
+typedef struct
+{
+    short               counts[MAXBITS + 1];
+    short               symbols[MAXLCODES];
+} huffman_t;
+
+typedef struct
+{
+    FILE                *fstream;
+    unsigned int        remaining;
+    byte                buffer[INFLATEBUFFERSIZE];
+    unsigned int        bufferpos;
+    unsigned int        bufferlen;
+
+    unsigned int        bitbuf;
+    int                 bitcount;
+
+    byte                *dest;
+    unsigned int        destpos;
+    unsigned int        destlen;
+
+    dboolean            error;
+} inflate_t;
+
+static const short lengthbase[29] =
+{
+      3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  15,  17,  19,  23, 27,
+     31,  35,  43,  51,  59,  67,  83,  99, 115, 131, 163, 195, 227, 258
+};
+
+static const short lengthextra[29] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const short distbase[30] =
+{
+       1,    2,    3,    4,    5,    7,    9,    13,    17,    25,   33,   49,   65,   97,  129,
+     193,  257,  385,  513,  769, 1025, 1537, 2049,  3073,  4097,  6145, 8193, 12289, 16385, 24577
+};
+
+static const short distextra[30] =
+{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static int NextByte(inflate_t *s)
+{
+    if (s->bufferpos == s->bufferlen)
+    {
+        unsigned int    len = (s->remaining < INFLATEBUFFERSIZE ? s->remaining : INFLATEBUFFERSIZE);
+
+        s->bufferlen = (len ? fread(s->buffer, 1, len, s->fstream) : 0);
+        s->bufferpos = 0;
+        s->remaining -= s->bufferlen;
+
+        if (!s->bufferlen)
+        {
+            s->error = true;
+            return 0;
+        }
+    }
+
+    return s->buffer[s->bufferpos++];
+}
+
+static int GetBits(inflate_t *s, int count)
+{
+    int result;
+
+    while (s->bitcount < count)
+    {
+        s->bitbuf |= NextByte(s) << s->bitcount;
+        s->bitcount += 8;
+    }
+
+    result = s->bitbuf & ((1 << count) - 1);
+    s->bitbuf >>= count;
+    s->bitcount -= count;
+
+    return result;
+}
+
+static void BuildHuffman(huffman_t *h, const byte *lengths, int count)
+{
+    short       offsets[MAXBITS + 1];
+    int         i;
+
+    memset(h->counts, 0, sizeof(h->counts));
+    for (i = 0; i < count; ++i)
+        h->counts[lengths[i]]++;
+    h->counts[0] = 0;
+
+    offsets[1] = 0;
+    for (i = 1; i < MAXBITS; ++i)
+        offsets[i + 1] = offsets[i] + h->counts[i];
+
+    for (i = 0; i < count; ++i)
+        if (lengths[i])
+            h->symbols[offsets[lengths[i]]++] = i;
+}
+
+static int DecodeSymbol(inflate_t *s, huffman_t *h)
+{
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    int len;
+
+    for (len = 1; len <= MAXBITS; ++len)
+    {
+        int     count = h->counts[len];
+
+        code |= GetBits(s, 1);
+        if (code - count < first)
+            return h->symbols[index + code - first];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+
+    s->error = true;
+    return -1;
+}
+
+static void InflateStored(inflate_t *s)
+{
+    unsigned int        len;
+    unsigned int        nlen;
+
+    // skip to the next byte
+    s->bitbuf = 0;
+    s->bitcount = 0;
+
+    len = NextByte(s);
+    len |= NextByte(s) << 8;
+    nlen = NextByte(s);
+    nlen |= NextByte(s) << 8;
+    if (nlen != (~len & 0xFFFF) || s->destpos + len > s->destlen)
+    {
+        s->error = true;
+        return;
+    }
+
+    while (len-- && !s->error)
+        s->dest[s->destpos++] = NextByte(s);
+}
+
+static void InflateCodes(inflate_t *s, huffman_t *lencode, huffman_t *distcode)
+{
+    while (!s->error)
+    {
+        int     symbol = DecodeSymbol(s, lencode);
+
+        if (symbol < 256)
+        {
+            if (s->destpos == s->destlen)
+                break;
+            s->dest[s->destpos++] = symbol;
+        }
+        else if (symbol == 256)
+            return;
+        else
+        {
+            unsigned int        len;
+            unsigned int        dist;
+
+            symbol -= 257;
+            if (symbol >= 29)
+                break;
+            len = lengthbase[symbol] + GetBits(s, lengthextra[symbol]);
+
+            symbol = DecodeSymbol(s, distcode);
+            if (symbol < 0 || symbol >= 30)
+                break;
+            dist = distbase[symbol] + GetBits(s, distextra[symbol]);
+
+            if (dist > s->destpos || s->destpos + len > s->destlen)
+                break;
+            while (len--)
+            {
+                s->dest[s->destpos] = s->dest[s->destpos - dist];
+                s->destpos++;
+            }
+        }
+    }
+
+    s->error = true;
+}
+
+static void InflateFixed(inflate_t *s)
+{
+    static huffman_t    lencode;
+    static huffman_t    distcode;
+    static dboolean     built;
+
+    if (!built)
+    {
+        byte    lengths[MAXLCODES];
+        int     i;
+
+        for (i = 0; i < 144; ++i)
+            lengths[i] = 8;
+        for (; i < 256; ++i)
+            lengths[i] = 9;
+        for (; i < 280; ++i)
+            lengths[i] = 7;
+        for (; i < MAXLCODES; ++i)
+            lengths[i] = 8;
+        BuildHuffman(&lencode, lengths, MAXLCODES);
+
+        for (i = 0; i < MAXDCODES; ++i)
+            lengths[i] = 5;
+        BuildHuffman(&distcode, lengths, MAXDCODES);
+
+        built = true;
+    }
+
+    InflateCodes(s, &lencode, &distcode);
+}
+
+static void InflateDynamic(inflate_t *s)
+{
+    static const byte   order[19] =
+    {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+    };
+
+    byte                lengths[MAXLCODES + MAXDCODES];
+    huffman_t           lencode;
+    huffman_t           distcode;
+    int                 nlen = GetBits(s, 5) + 257;
+    int                 ndist = GetBits(s, 5) + 1;
+    int                 ncode = GetBits(s, 4) + 4;
+    int                 i;
+
+    if (nlen > MAXLCODES || ndist > MAXDCODES)
+    {
+        s->error = true;
+        return;
+    }
+
+    memset(lengths, 0, 19);
+    for (i = 0; i < ncode; ++i)
+        lengths[order[i]] = GetBits(s, 3);
+    BuildHuffman(&lencode, lengths, 19);
+
+    i = 0;
+    while (i < nlen + ndist && !s->error)
+    {
+        int     symbol = DecodeSymbol(s, &lencode);
+        int     len = 0;
+        int     repeat;
+
+        if (symbol < 16)
+        {
+            lengths[i++] = symbol;
+            continue;
+        }
+        else if (symbol == 16)
+        {
+            if (!i)
+                break;
+            len = lengths[i - 1];
+            repeat = 3 + GetBits(s, 2);
+        }
+        else if (symbol == 17)
+            repeat = 3 + GetBits(s, 3);
+        else
+            repeat = 11 + GetBits(s, 7);
+
+        if (i + repeat > nlen + ndist)
+            break;
+        while (repeat--)
+            lengths[i++] = len;
+    }
+
+    if (i < nlen + ndist || !lengths[256])
+    {
+        s->error = true;
+        return;
+    }
+
+    BuildHuffman(&lencode, lengths, nlen);
+    BuildHuffman(&distcode, lengths + nlen, ndist);
+    InflateCodes(s, &lencode, &distcode);
+}
+
+static dboolean Inflate(FILE *fstream, unsigned int compressedsize, byte *dest,
+    unsigned int destlen)
+{
+    inflate_t   *s = Z_Malloc(sizeof(inflate_t), PU_STATIC, NULL);
+    dboolean    last;
+    dboolean    result;
+
+    s->fstream = fstream;
+    s->remaining = compressedsize;
+    s->bufferpos = s->bufferlen = 0;
+    s->bitbuf = 0;
+    s->bitcount = 0;
+    s->dest = dest;
+    s->destpos = 0;
+    s->destlen = destlen;
+    s->error = false;
+
+    do
+    {
+        last = GetBits(s, 1);
+
+        switch (GetBits(s, 2))
+        {
+            case 0:
+                InflateStored(s);
+                break;
+
+            case 1:
+                InflateFixed(s);
+                break;
+
+            case 2:
+                InflateDynamic(s);
+                break;
+
+            default:
+                s->error = true;
+                break;
+        }
+    } while (!last && !s->error);
+
+    result = (!s->error && s->destpos == destlen);
+    Z_Free(s);
+
+    return result;
+}
+
+//
+// CACHE
+//
+
+static void UnlinkEntry(zipentry_t *entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        cachehead = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        cachetail = entry->prev;
+
+    entry->prev = entry->next = NULL;
+    entry->cached = false;
+    cachedbytes -= entry->size;
+}
+
+static void LinkEntry(zipentry_t *entry)
+{
+    entry->prev = NULL;
+    entry->next = cachehead;
+    if (cachehead)
+        cachehead->prev = entry;
+    else
+        cachetail = entry;
+    cachehead = entry;
+
+    entry->cached = true;
+    cachedbytes += entry->size;
+}
+
+// Free the least recently used lumps until the cache is within its budget.
+// Lumps that are in use are kept until they're released.
+static void TrimCache(size_t budget)
+{
+    zipentry_t  *entry = cachetail;
+
+    while (entry && cachedbytes > budget)
+    {
+        zipentry_t      *prev = entry->prev;
+
+        if (!entry->cache || entry->tag == PU_CACHE)
+        {
+            UnlinkEntry(entry);
+            Z_Free(entry->cache);
+        }
+
+        entry = prev;
+    }
+}
+
+// Decompress an entry into the provided buffer, which must be entry->size
+// bytes long.
+static dboolean ReadEntry(zip_wad_file_t *zip, zipentry_t *entry, byte *dest)
+{
+    byte        header[30];
+
+    fseek(zip->fstream, entry->offset, SEEK_SET);
+    if (fread(header, 1, sizeof(header), zip->fstream) != sizeof(header)
+        || ReadLong(header) != ZIP_LOCALHEADER)
+        return false;
+    fseek(zip->fstream, entry->offset + sizeof(header) + ReadShort(header + 26)
+        + ReadShort(header + 28), SEEK_SET);
+
+    if (entry->method == ZIP_STORED)
+        return (fread(dest, 1, entry->size, zip->fstream) == entry->size);
+    else
+        return Inflate(zip->fstream, entry->compressedsize, dest, entry->size);
+}
+
+// Return the decompressed lump of an entry, from the cache if it's there.
+// If the lump is too big for the cache, a copy is returned that the caller
+// must free.
+static byte *GetEntry(zip_wad_file_t *zip, zipentry_t *entry, dboolean *temporary)
+{
+    size_t      budget = (size_t)zipcachesize << 20;
+    byte        *data;
+
+    *temporary = false;
+
+    if (entry->cached)
+    {
+        // the zone may have purged it
+        UnlinkEntry(entry);
+        if (entry->cache)
+        {
+            LinkEntry(entry);
+            return entry->cache;
+        }
+    }
+
+    if (entry->size > budget)
+    {
+        data = Z_Malloc(entry->size, PU_STATIC, NULL);
+        if (!ReadEntry(zip, entry, data))
+        {
+            Z_Free(data);
+            return NULL;
+        }
+        *temporary = true;
+        return data;
+    }
+
+    TrimCache(budget - entry->size);
+    Z_Malloc(entry->size, PU_CACHE, (void **)&entry->cache);
+    if (!ReadEntry(zip, entry, entry->cache))
+    {
+        Z_Free(entry->cache);
+        return NULL;
+    }
+    entry->tag = PU_CACHE;
+    LinkEntry(entry);
+    return entry->cache;
+}
+
+// Return the entry that the data at the specified position in the virtual
+// WAD is in, which must be past the directory.
+static zipentry_t *FindEntry(zip_wad_file_t *zip, unsigned int offset)
+{
+    int low = 0;
+    int high = zip->numentries - 1;
+
+    while (low < high)
+    {
+        int     mid = (low + high + 1) / 2;
+
+        if (zip->entries[mid].position <= offset)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+
+    return &zip->entries[low];
+}
+
+//
+// DIRECTORY
+//
+
+// Find the end of central directory record, which is at the end of the file
+// followed by a comment of up to 64KB.
+static dboolean FindCentralDirectory(FILE *fstream, unsigned int length, byte *record)
+{
+    unsigned int        len = (length < ZIP_MAXCOMMENT + 22 ? length : ZIP_MAXCOMMENT + 22);
+    byte                *buffer = Z_Malloc(len, PU_STATIC, NULL);
+    dboolean            result = false;
+    int                 i;
+
+    fseek(fstream, length - len, SEEK_SET);
+    if (fread(buffer, 1, len, fstream) == len)
+        for (i = len - 22; i >= 0; --i)
+            if (ReadLong(buffer + i) == ZIP_ENDOFCENTRALDIR)
+            {
+                memcpy(record, buffer + i, 22);
+                result = true;
+                break;
+            }
+
+    Z_Free(buffer);
+    return result;
+}
+
+// Name a lump after the base of the entry's filename, and put it in a
+// namespace if it's in the flats or sprites folders.
+static dboolean GetEntryName(char *path, char *name, zipnamespace_t *ns)
+{
+    char        *base = strrchr(path, '/');
+    int         i;
+
+    base = (base ? base + 1 : path);
+    if (!*base)
+        return false;
+
+    if (!strncasecmp(path, "flats/", 6))
+        *ns = ns_flats;
+    else if (!strncasecmp(path, "sprites/", 8))
+        *ns = ns_sprites;
+    else
+        *ns = ns_global;
+
+    memset(name, 0, 8);
+    for (i = 0; i < 8 && base[i] && base[i] != '.'; ++i)
+        name[i] = toupper(base[i]);
+
+    return true;
+}
+
+static void AddMarker(zipentry_t *entries, int *count, char *name)
+{
+    zipentry_t  *entry = &entries[(*count)++];
+
+    memset(entry, 0, sizeof(*entry));
+    memcpy(entry->name, name, strlen(name));
+}
+
+static dboolean ReadDirectory(zip_wad_file_t *zip, char *path)
+{
+    byte                record[22];
+    byte                *central;
+    byte                *p;
+    unsigned int        centralsize;
+    int                 numfiles;
+    zipentry_t          *files;
+    zipnamespace_t      *namespaces;
+    int                 count = 0;
+    int                 i;
+    int                 ns;
+    unsigned int        position;
+    byte                *dir;
+
+    if (!FindCentralDirectory(zip->fstream, zip->wad.length, record))
+        return false;
+
+    numfiles = ReadShort(record + 10);
+    centralsize = ReadLong(record + 12);
+    central = Z_Malloc(centralsize, PU_STATIC, NULL);
+    fseek(zip->fstream, ReadLong(record + 16), SEEK_SET);
+    if (fread(central, 1, centralsize, zip->fstream) != centralsize)
+    {
+        Z_Free(central);
+        return false;
+    }
+
+    files = Z_Malloc(numfiles * sizeof(zipentry_t), PU_STATIC, NULL);
+    namespaces = Z_Malloc(numfiles * sizeof(zipnamespace_t), PU_STATIC, NULL);
+    p = central;
+
+    for (i = 0; i < numfiles && p + 46 <= central + centralsize; ++i)
+    {
+        unsigned int    namelen = ReadShort(p + 28);
+        unsigned int    len;
+        int             method = ReadShort(p + 10);
+        char            filename[260];
+        zipentry_t      *entry = &files[count];
+
+        if (ReadLong(p) != ZIP_CENTRALHEADER || p + 46 + namelen > central + centralsize)
+            break;
+
+        len = (namelen < sizeof(filename) ? namelen : sizeof(filename) - 1);
+        memcpy(filename, p + 46, len);
+        filename[len] = '\0';
+
+        if (GetEntryName(filename, entry->name, &namespaces[count]))
+        {
+            if ((ReadShort(p + 8) & 1) || (method != ZIP_STORED && method != ZIP_DEFLATED))
+                C_Warning("%s in %s is encrypted or compressed in an unsupported way.",
+                    uppercase(filename), uppercase(path));
+            else if (W_IsWADFile(filename))
+                C_Warning("%s in %s is a WAD file, which isn't supported.",
+                    uppercase(filename), uppercase(path));
+            else
+            {
+                entry->method = method;
+                entry->compressedsize = ReadLong(p + 20);
+                entry->size = ReadLong(p + 24);
+                entry->offset = ReadLong(p + 42);
+                entry->cache = NULL;
+                entry->cached = false;
+                entry->tag = PU_CACHE;
+                entry->prev = entry->next = NULL;
+                ++count;
+            }
+        }
+
+        p += 46 + namelen + ReadShort(p + 30) + ReadShort(p + 32);
+    }
+
+    Z_Free(central);
+
+    // Order the lumps by namespace, adding markers around flats and sprites.
+    zip->entries = Z_Malloc((count + 4) * sizeof(zipentry_t), PU_STATIC, NULL);
+    zip->numentries = 0;
+
+    for (ns = ns_global; ns <= ns_sprites; ++ns)
+    {
+        dboolean        found = false;
+
+        for (i = 0; i < count; ++i)
+            if (namespaces[i] == ns)
+            {
+                if (!found && ns != ns_global)
+                    AddMarker(zip->entries, &zip->numentries, (ns == ns_flats ? "FF_START" : "SS_START"));
+                found = true;
+                zip->entries[zip->numentries++] = files[i];
+            }
+
+        if (found && ns != ns_global)
+            AddMarker(zip->entries, &zip->numentries, (ns == ns_flats ? "FF_END" : "SS_END"));
+    }
+
+    Z_Free(files);
+    Z_Free(namespaces);
+
+    // Build the header and directory of the virtual WAD.
+    zip->directorysize = 12 + zip->numentries * 16;
+    zip->directory = dir = Z_Malloc(zip->directorysize, PU_STATIC, NULL);
+    memcpy(dir, "PWAD", 4);
+    *(int *)(dir + 4) = LONG(zip->numentries);
+    *(int *)(dir + 8) = LONG(12);
+    dir += 12;
+
+    position = zip->directorysize;
+    for (i = 0; i < zip->numentries; ++i)
+    {
+        zipentry_t      *entry = &zip->entries[i];
+
+        entry->position = position;
+        position += entry->size;
+
+        *(int *)dir = LONG(entry->position);
+        *(int *)(dir + 4) = LONG(entry->size);
+        memcpy(dir + 8, entry->name, 8);
+        dir += 16;
+    }
+
+    zip->wad.length = position;
+
+    return true;
+}
+
+static wad_file_t *W_Zip_OpenFile(char *path)
+{
+    zip_wad_file_t      *result;
+    FILE                *fstream;
+
+    fstream = fopen(path, "rb");
+
+    if (!fstream)
+        return NULL;
+
+    result = Z_Malloc(sizeof(zip_wad_file_t), PU_STATIC, 0);
+    result->wad.file_class = &zip_wad_file;
+    result->wad.mapped = NULL;
+    result->wad.length = M_FileLength(fstream);
+    result->fstream = fstream;
+
+    if (!ReadDirectory(result, path))
+    {
+        C_Warning("%s isn't a valid zip file.", uppercase(path));
+        fclose(fstream);
+        Z_Free(result);
+        return NULL;
+    }
+
+    return &result->wad;
+}
+
+static void W_Zip_CloseFile(wad_file_t *wad)
+{
+    zip_wad_file_t      *zip = (zip_wad_file_t *)wad;
+    int                 i;
+
+    Z_Lock();
+
+    for (i = 0; i < zip->numentries; ++i)
+        if (zip->entries[i].cached)
+        {
+            UnlinkEntry(&zip->entries[i]);
+            Z_Free(zip->entries[i].cache);
+        }
+
+    Z_Unlock();
+
+    fclose(zip->fstream);
+    Z_Free(zip->entries);
+    Z_Free(zip->directory);
+    Z_Free(zip);
+}
+
+// Read data from the specified position in the virtual WAD into the
+// provided buffer, decompressing any lumps it covers. A lump that is read
+// whole and isn't already in the cache is decompressed straight into the
+// buffer, rather than being kept as well. The zone is locked while reading,
+// so the cache can't be purged from under it by another thread.
+static size_t W_Zip_Read(wad_file_t *wad, unsigned int offset, void *buffer, size_t buffer_len)
+{
+    zip_wad_file_t      *zip = (zip_wad_file_t *)wad;
+    byte                *dest = buffer;
+    size_t              result = 0;
+    zipentry_t          *entry;
+    zipentry_t          *end = zip->entries + zip->numentries;
+
+    if (offset < zip->directorysize)
+    {
+        size_t  len = zip->directorysize - offset;
+
+        if (len > buffer_len)
+            len = buffer_len;
+
+        memcpy(dest, zip->directory + offset, len);
+        dest += len;
+        offset += len;
+        buffer_len -= len;
+        result += len;
+    }
+
+    if (!buffer_len || !zip->numentries)
+        return result;
+
+    Z_Lock();
+
+    for (entry = FindEntry(zip, offset); entry < end && buffer_len; ++entry)
+    {
+        unsigned int    start = offset - entry->position;
+        size_t          len;
+
+        if (start >= entry->size)
+            continue;
+
+        len = entry->size - start;
+        if (len > buffer_len)
+            len = buffer_len;
+
+        if (!start && len == entry->size && !entry->cache)
+        {
+            if (!ReadEntry(zip, entry, dest))
+                break;
+        }
+        else
+        {
+            byte        *data;
+            dboolean    temporary;
+
+            if (!(data = GetEntry(zip, entry, &temporary)))
+                break;
+
+            memcpy(dest, data + start, len);
+            if (temporary)
+                Z_Free(data);
+        }
+
+        dest += len;
+        offset += len;
+        buffer_len -= len;
+        result += len;
+    }
+
+    Z_Unlock();
+
+    return result;
+}
+
+// Return a lump from the cache, decompressing it first if it isn't there,
+// with its zone tag changed to the one given. Lumps too big for the cache
+// are left to be read into a zone block of their own.
+static void *W_Zip_CacheLump(wad_file_t *wad, unsigned int offset, size_t length, int tag)
+{
+    zip_wad_file_t      *zip = (zip_wad_file_t *)wad;
+    zipentry_t          *entry;
+    byte                *data = NULL;
+    dboolean            temporary;
+
+    if (!length || offset < zip->directorysize || !zip->numentries)
+        return NULL;
+
+    Z_Lock();
+
+    entry = FindEntry(zip, offset);
+
+    if (entry->position == offset && entry->size == length
+        && (entry->cache || length <= ((size_t)zipcachesize << 20))
+        && (data = GetEntry(zip, entry, &temporary)))
+    {
+        Z_ChangeTag(data, tag);
+        entry->tag = tag;
+    }
+
+    Z_Unlock();
+
+    return data;
+}
+
+// Let a lump in the cache be freed again once it's no longer in use.
+static void W_Zip_ReleaseLump(wad_file_t *wad, unsigned int offset)
+{
+    zip_wad_file_t      *zip = (zip_wad_file_t *)wad;
+    zipentry_t          *entry;
+
+    if (offset < zip->directorysize || !zip->numentries)
+        return;
+
+    Z_Lock();
+
+    entry = FindEntry(zip, offset);
+
+    if (entry->position == offset && entry->cache)
+    {
+        Z_ChangeTag(entry->cache, PU_CACHE);
+        entry->tag = PU_CACHE;
+    }
+
+    Z_Unlock();
+}
+
+wad_file_class_t zip_wad_file =
+{
+    W_Zip_OpenFile,
+    W_Zip_CloseFile,
+    W_Zip_Read,
+    NULL,
+    W_Zip_CacheLump,
+    W_Zip_ReleaseLump
+};
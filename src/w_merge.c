@@ -36,10 +36,14 @@
 ========================================================================
 */
 
+#include <ctype.h>
+
+#include "c_console.h"
 #include "doomdef.h"
 #include "doomstat.h"
 #include "info.h"
 #include "i_system.h"
+#include "i_timer.h"
 #include "m_misc.h"
 #include "w_wad.h"
 #include "z_zone.h"
@@ -51,10 +55,20 @@ typedef enum
     SECTION_SPRITES
 } section_t;
 
+typedef struct
+{
+    uint64_t            key;
+    int                 index;
+} hashentry_t;
+
 typedef struct
 {
     lumpinfo_t          *lumps;
     int                 numlumps;
+
+    // Lumps hashed by name, built the first time the list is searched
+    hashentry_t         *hash;
+    unsigned int        hashmask;
 } searchlist_t;
 
 typedef struct
@@ -77,17 +91,80 @@ static sprite_frame_t   *sprite_frames;
 static int              num_sprite_frames;
 static int              sprite_frames_alloced;
 
+// sprite frames hashed by name and frame
+static hashentry_t      *sprite_frame_hash;
+static unsigned int     sprite_frame_hashmask;
+
+// Fibonacci hashing of a key into a hash table
+static unsigned int KeyHash(uint64_t key, unsigned int mask)
+{
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+static hashentry_t *NewHashTable(unsigned int size)
+{
+    hashentry_t         *hash = Z_Malloc(size * sizeof(hashentry_t), PU_STATIC, NULL);
+    unsigned int        i;
+
+    for (i = 0; i < size; ++i)
+        hash[i].index = -1;
+
+    return hash;
+}
+
+static void FreeList(searchlist_t *list)
+{
+    if (list->hash)
+    {
+        Z_Free(list->hash);
+        list->hash = NULL;
+    }
+}
+
+// Hash the lumps in a list by name. Where lumps share a name, the first
+// one is kept, as a linear search would find it.
+static void HashList(searchlist_t *list)
+{
+    unsigned int        size = 16;
+    int                 i;
+
+    while (size < (unsigned int)list->numlumps * 2)
+        size <<= 1;
+
+    list->hash = NewHashTable(size);
+    list->hashmask = size - 1;
+
+    for (i = 0; i < list->numlumps; ++i)
+    {
+        uint64_t        key = W_LumpNameKey(list->lumps[i].name);
+        unsigned int    hash = KeyHash(key, list->hashmask);
+
+        while (list->hash[hash].index >= 0 && list->hash[hash].key != key)
+            hash = (hash + 1) & list->hashmask;
+
+        if (list->hash[hash].index < 0)
+        {
+            list->hash[hash].key = key;
+            list->hash[hash].index = i;
+        }
+    }
+}
+
 // Search in a list to find a lump with a particular name
-// Linear search (slow!)
 //
 // Returns -1 if not found
 static int FindInList(searchlist_t *list, char *name)
 {
-    int i;
+    uint64_t            key = W_LumpNameKey(name);
+    unsigned int        hash;
 
-    for (i = 0; i < list->numlumps; ++i)
-        if (!strncasecmp(list->lumps[i].name, name, 8))
-            return i;
+    if (!list->hash)
+        HashList(list);
+
+    for (hash = KeyHash(key, list->hashmask); list->hash[hash].index >= 0;
+        hash = (hash + 1) & list->hashmask)
+        if (list->hash[hash].key == key)
+            return list->hash[hash].index;
 
     return -1;
 }
@@ -97,6 +174,7 @@ static dboolean SetupList(searchlist_t *list, searchlist_t *src_list,
 {
     int startlump;
 
+    FreeList(list);
     list->numlumps = 0;
     startlump = FindInList(src_list, startname);
 
@@ -136,6 +214,42 @@ static void SetupLists(void)
     SetupList(&pwad_sprites, &pwad, "S_START", "S_END", "SS_START", "SS_END");
 }
 
+// Packs the sprite name, in uppercase, and frame of a sprite frame into a
+// key for the hash table.
+static uint64_t SpriteFrameKey(char *name, char frame)
+{
+    uint64_t    key = (uint64_t)(byte)frame << 32;
+    int         i;
+
+    for (i = 0; i < 4 && name[i] != '\0'; ++i)
+        key |= (uint64_t)(byte)toupper(name[i]) << (i * 8);
+
+    return key;
+}
+
+// Hash the sprite frames, with a table twice the size of the list.
+static void HashSpriteFrames(void)
+{
+    int i;
+
+    if (sprite_frame_hash)
+        Z_Free(sprite_frame_hash);
+    sprite_frame_hash = NewHashTable(sprite_frames_alloced * 2);
+    sprite_frame_hashmask = sprite_frames_alloced * 2 - 1;
+
+    for (i = 0; i < num_sprite_frames; ++i)
+    {
+        uint64_t        key = SpriteFrameKey(sprite_frames[i].sprname, sprite_frames[i].frame);
+        unsigned int    hash = KeyHash(key, sprite_frame_hashmask);
+
+        while (sprite_frame_hash[hash].index >= 0)
+            hash = (hash + 1) & sprite_frame_hashmask;
+
+        sprite_frame_hash[hash].key = key;
+        sprite_frame_hash[hash].index = i;
+    }
+}
+
 // Initialize the replace list
 static void InitSpriteList(void)
 {
@@ -146,22 +260,22 @@ static void InitSpriteList(void)
     }
 
     num_sprite_frames = 0;
+    HashSpriteFrames();
 }
 
 // Find a sprite frame
 static sprite_frame_t *FindSpriteFrame(char *name, char frame)
 {
     sprite_frame_t      *result;
+    uint64_t            key = SpriteFrameKey(name, frame);
+    unsigned int        hash;
     int                 i;
 
-    // Search the list and try to find the frame
-    for (i = 0; i < num_sprite_frames; ++i)
-    {
-        sprite_frame_t *cur = &sprite_frames[i];
-
-        if (!strncasecmp(cur->sprname, name, 4) && cur->frame == frame)
-            return cur;
-    }
+    // Search the hash table and try to find the frame
+    for (hash = KeyHash(key, sprite_frame_hashmask); sprite_frame_hash[hash].index >= 0;
+        hash = (hash + 1) & sprite_frame_hashmask)
+        if (sprite_frame_hash[hash].key == key)
+            return &sprite_frames[sprite_frame_hash[hash].index];
 
     // Not found in list; Need to add to the list
 
@@ -175,8 +289,16 @@ static sprite_frame_t *FindSpriteFrame(char *name, char frame)
         Z_Free(sprite_frames);
         sprite_frames_alloced *= 2;
         sprite_frames = newframes;
+
+        HashSpriteFrames();
+        hash = KeyHash(key, sprite_frame_hashmask);
+        while (sprite_frame_hash[hash].index >= 0)
+            hash = (hash + 1) & sprite_frame_hashmask;
     }
 
+    sprite_frame_hash[hash].key = key;
+    sprite_frame_hash[hash].index = num_sprite_frames;
+
     // Add to end of list
     result = &sprite_frames[num_sprite_frames];
     strncpy(result->sprname, name, 4);
@@ -460,6 +582,7 @@ static void DoMerge(void)
 dboolean W_MergeFile(char *filename, dboolean automatic)
 {
     int old_numlumps;
+    int mergetime;
 
     old_numlumps = numlumps;
 
@@ -467,7 +590,11 @@ dboolean W_MergeFile(char *filename, dboolean automatic)
     if (!W_AddFile(filename, automatic))
         return false;
 
+    mergetime = I_GetTimeMS();
+
     // IWAD is at the start, PWAD was appended to the end
+    FreeList(&iwad);
+    FreeList(&pwad);
     iwad.lumps = lumpinfo;
     iwad.numlumps = old_numlumps;
 
@@ -483,5 +610,21 @@ dboolean W_MergeFile(char *filename, dboolean automatic)
     // Perform the merge
     DoMerge();
 
+    // The hashed lists point into the old lumpinfo
+    FreeList(&iwad);
+    FreeList(&iwad_sprites);
+    FreeList(&iwad_flats);
+    FreeList(&pwad);
+    FreeList(&pwad_sprites);
+    FreeList(&pwad_flats);
+
+    // The lumps have been reordered
+    W_ResolveLumpRefs();
+
+    // Only time the PWADs the player chose, not those added automatically
+    if (!automatic)
+        C_Output("Merged %s with the lumps already added in %ims.", uppercase(filename),
+            I_GetTimeMS() - mergetime);
+
     return true;
 }
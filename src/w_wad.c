@@ -39,6 +39,7 @@
 #include <ctype.h>
 
 #include "c_console.h"
+#include "d_main.h"
 #include "doomdef.h"
 #include "doomstat.h"
 #include "i_swap.h"
@@ -79,8 +80,22 @@ typedef struct
 lumpinfo_t      *lumpinfo;
 unsigned int    numlumps = 0;
 
-// Hash table for fast lookups
-static lumpinfo_t **lumphash;
+// Hash table for fast lookups. Each lump name is stored as a 64-bit key, and
+// collisions are resolved by linear probing.
+typedef struct
+{
+    uint64_t    key;
+    int         lump;
+} lumphashentry_t;
+
+static lumphashentry_t  *lumphash;
+static unsigned int     lumphashmask;
+
+// Lump names that have been looked up once and kept
+static lumpref_t        *lumprefs;
+
+// The number of lumps looked up by name since startup
+int                     lumplookups;
 
 void ExtractFileBase(char *path, char *dest)
 {
@@ -117,6 +132,25 @@ unsigned int W_LumpNameHash(const char *s)
     return result;
 }
 
+// Packs the first 8 characters of a lump name, in uppercase, into a key
+// that can be compared in one go.
+uint64_t W_LumpNameKey(const char *s)
+{
+    uint64_t    key = 0;
+    int         i;
+
+    for (i = 0; i < 8 && s[i] != '\0'; ++i)
+        key |= (uint64_t)(byte)toupper(s[i]) << (i * 8);
+
+    return key;
+}
+
+// Fibonacci hashing of a lump name's key into the hash table.
+static unsigned int W_LumpKeyHash(uint64_t key)
+{
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 32) & lumphashmask;
+}
+
 // Increase the size of the lumpinfo[] array to the specified size.
 static void ExtendLumpInfo(int newnumlumps)
 {
@@ -137,11 +171,6 @@ static void ExtendLumpInfo(int newnumlumps)
 
         if (newlumpinfo[i].cache)
             Z_ChangeUser(newlumpinfo[i].cache, &newlumpinfo[i].cache);
-
-        // We shouldn't be generating a hash table until after all WADs have
-        // been loaded, but just in case...
-        if (lumpinfo[i].next)
-            newlumpinfo[i].next = &newlumpinfo[lumpinfo[i].next - lumpinfo];
     }
 
     // All done.
@@ -173,11 +202,16 @@ wad_file_t *W_AddFile(char *filename, dboolean automatic)
     filelump_t          *filerover;
     int                 newnumlumps;
 
+    D_BeginTask("W_AddFile", uppercase(M_ExtractFilename(filename)));
+
     // open the file and add to directory
     wad_file = W_OpenFile(filename);
 
     if (!wad_file)
+    {
+        D_EndTask();
         return NULL;
+    }
 
     M_StringCopy(wad_file->path, filename, sizeof(wad_file->path));
     
@@ -185,7 +219,7 @@ wad_file_t *W_AddFile(char *filename, dboolean automatic)
 
     newnumlumps = numlumps;
 
-    if (strcasecmp(filename + strlen(filename) - 3, "wad"))
+    if (strcasecmp(filename + strlen(filename) - 3, "wad") && !W_IsZipFile(filename))
     {
         // single lump file
 
@@ -206,7 +240,7 @@ wad_file_t *W_AddFile(char *filename, dboolean automatic)
     {
         int     length;
 
-        // WAD file
+        // WAD file, or a zip file presented as one
         W_Read(wad_file, 0, &header, sizeof(header));
 
         // Homebrew levels?
@@ -252,10 +286,14 @@ wad_file_t *W_AddFile(char *filename, dboolean automatic)
         lumphash = NULL;
     }
 
+    W_ResolveLumpRefs();
+
     C_Output("%s %s lumps from %.4s file %s.",
         (automatic ? "Automatically added" : "Added"), commify(numlumps - startlump),
         header.identification, uppercase(filename));
 
+    D_EndTask();
+
     return wad_file;
 }
 
@@ -395,19 +433,18 @@ int W_NumLumps(void)
 //
 int W_CheckNumForName(char *name)
 {
-    lumpinfo_t  *lump_p;
+    ++lumplookups;
 
     // Do we have a hash table yet?
     if (lumphash)
     {
-        int     hash;
-
         // We do! Excellent.
-        hash = W_LumpNameHash(name) % numlumps;
+        uint64_t        key = W_LumpNameKey(name);
+        unsigned int    hash;
 
-        for (lump_p = lumphash[hash]; lump_p; lump_p = lump_p->next)
-            if (!strncasecmp(lump_p->name, name, 8))
-                return lump_p - lumpinfo;
+        for (hash = W_LumpKeyHash(key); lumphash[hash].lump >= 0; hash = (hash + 1) & lumphashmask)
+            if (lumphash[hash].key == key)
+                return lumphash[hash].lump;
     }
     else
     {
@@ -561,26 +598,39 @@ void *W_CacheLumpNum(int lumpnum, int tag)
 
     // Get the pointer to return.  If the lump is in a memory-mapped
     // file, we can just return a pointer to within the memory-mapped
-    // region.  If the lump is in an ordinary file, we may already
-    // have it cached; otherwise, load it into memory.
+    // region.  If the lump is in a file that keeps its own cache, such
+    // as a zip file, return the copy in that cache.  If the lump is in
+    // an ordinary file, we may already have it cached; otherwise, load
+    // it into memory.
 
     if (lump->wad_file->mapped)
     {
         // Memory mapped file, return from the mmapped region.
         result = lump->wad_file->mapped + lump->position;
     }
-    else if (lump->cache)
-    {
-        // Already cached, so just switch the zone tag.
-        result = (byte *)lump->cache;
-        Z_ChangeTag(lump->cache, tag);
-    }
     else
     {
-        // Not yet loaded, so load it now
-        lump->cache = Z_Malloc(W_LumpLength(lumpnum), tag, &lump->cache);
-        W_ReadLump(lumpnum, lump->cache);
-        result = (byte *)lump->cache;
+        Z_Lock();
+
+        // The file's own cache switches the zone tag itself.
+        if (!(result = W_CacheLump(lump->wad_file, lump->position, lump->size, tag)))
+        {
+            if (lump->cache)
+            {
+                // Already cached, so just switch the zone tag.
+                result = (byte *)lump->cache;
+                Z_ChangeTag(lump->cache, tag);
+            }
+            else
+            {
+                // Not yet loaded, so load it now
+                lump->cache = Z_Malloc(W_LumpLength(lumpnum), tag, &lump->cache);
+                W_ReadLump(lumpnum, lump->cache);
+                result = (byte *)lump->cache;
+            }
+        }
+
+        Z_Unlock();
     }
 
     return result;
@@ -594,6 +644,49 @@ void *W_CacheLumpName(char *name, int tag)
     return W_CacheLumpNum(W_GetNumForName(name), tag);
 }
 
+//
+// W_GetNumForLumpRef
+// Returns the number of the lump a lumpref_t names, looking it up the first
+//  time.
+//
+int W_GetNumForLumpRef(lumpref_t *ref)
+{
+    if (ref->lump < 0)
+    {
+        ref->lump = W_GetNumForName(ref->name);
+
+        if (!ref->registered)
+        {
+            ref->registered = true;
+            ref->next = lumprefs;
+            lumprefs = ref;
+        }
+    }
+
+    return ref->lump;
+}
+
+//
+// W_CacheLumpRef
+//
+void *W_CacheLumpRef(lumpref_t *ref, int tag)
+{
+    return W_CacheLumpNum(W_GetNumForLumpRef(ref), tag);
+}
+
+//
+// W_ResolveLumpRefs
+// Looks up the lump names that have been kept again, after the lump numbers
+//  have changed.
+//
+void W_ResolveLumpRefs(void)
+{
+    lumpref_t   *ref;
+
+    for (ref = lumprefs; ref; ref = ref->next)
+        ref->lump = W_CheckNumForName(ref->name);
+}
+
 //
 // Release a lump back to the cache, so that it can be reused later
 // without having to read from disk again, or alternatively, discarded
@@ -613,7 +706,10 @@ void W_ReleaseLumpNum(int lumpnum)
     lump = &lumpinfo[lumpnum];
 
     if (!lump->wad_file->mapped)
+    {
         Z_ChangeTag(lump->cache, PU_CACHE);
+        W_ReleaseLump(lump->wad_file, lump->position);
+    }
 }
 
 void W_ReleaseLumpName(char *name)
@@ -621,31 +717,76 @@ void W_ReleaseLumpName(char *name)
     W_ReleaseLumpNum(W_GetNumForName(name));
 }
 
+//
+// W_PrefetchLumpNum
+// If the lump is in a memory-mapped file, have the OS start reading it in
+// now, so it doesn't fault page by page when it is first used.
+//
+void W_PrefetchLumpNum(int lumpnum)
+{
+    lumpinfo_t  *lump;
+
+    if ((unsigned int)lumpnum >= numlumps)
+        I_Error("W_PrefetchLumpNum: %i >= numlumps", lumpnum);
+
+    lump = &lumpinfo[lumpnum];
+    W_Advise(lump->wad_file, lump->position, lump->size, true);
+}
+
+//
+// W_DiscardLumpNum
+// If the lump is in a memory-mapped file, let the OS drop it from memory
+// until it is needed again.
+//
+void W_DiscardLumpNum(int lumpnum)
+{
+    lumpinfo_t  *lump;
+
+    if ((unsigned int)lumpnum >= numlumps)
+        I_Error("W_DiscardLumpNum: %i >= numlumps", lumpnum);
+
+    lump = &lumpinfo[lumpnum];
+    W_Advise(lump->wad_file, lump->position, lump->size, false);
+}
+
 // Generate a hash table for fast lookups
 void W_GenerateHashTable(void)
 {
     // Free the old hash table, if there is one
     if (lumphash)
+    {
         Z_Free(lumphash);
+        lumphash = NULL;
+    }
 
     // Generate hash table
     if (numlumps > 0)
     {
+        unsigned int    size = 1;
         unsigned int    i;
 
-        lumphash = Z_Malloc(sizeof(lumpinfo_t *) * numlumps, PU_STATIC, NULL);
-        memset(lumphash, 0, sizeof(lumpinfo_t *) * numlumps);
+        // keep the table no more than half full, so probes stay short
+        while (size < numlumps * 2)
+            size <<= 1;
+
+        lumphash = Z_Malloc(sizeof(lumphashentry_t) * size, PU_STATIC, NULL);
+        lumphashmask = size - 1;
+
+        for (i = 0; i < size; ++i)
+            lumphash[i].lump = -1;
 
         for (i = 0; i < numlumps; ++i)
         {
-            unsigned int        hash;
-
-            hash = W_LumpNameHash(lumpinfo[i].name) % numlumps;
+            uint64_t            key = W_LumpNameKey(lumpinfo[i].name);
+            unsigned int        hash = W_LumpKeyHash(key);
 
-            // Hook into the hash table
+            // Hook into the hash table. A lump loaded later replaces one of
+            // the same name, so patch lump files take precedence.
+            while (lumphash[hash].lump >= 0 && lumphash[hash].key != key)
+                hash = (hash + 1) & lumphashmask;
 
-            lumpinfo[i].next = lumphash[hash];
-            lumphash[hash] = &lumpinfo[i];
+            lumphash[hash].key = key;
+            lumphash[hash].lump = i;
         }
     }
 
@@ -65,14 +65,25 @@ struct lumpinfo_s
     int         position;
     int         size;
     void        *cache;
-
-    // Used for hash table lookups
-    lumpinfo_t  *next;
 };
 
 extern lumpinfo_t *lumpinfo;
 extern unsigned int numlumps;
 
+// A lump name that is looked up once, the first time it's used, rather than
+// every time. It is looked up again whenever WADs are added or merged.
+typedef struct lumpref_s
+{
+    char                *name;
+    int                 lump;
+    dboolean            registered;
+    struct lumpref_s    *next;
+} lumpref_t;
+
+#define LUMPREF(name)   { name, -1, false, NULL }
+
+extern int lumplookups;
+
 wad_file_t *W_AddFile(char *filename, dboolean automatic);
 int W_WadType(char *filename);
 
@@ -90,13 +101,21 @@ void W_ReadLump(unsigned int lump, void *dest);
 void *W_CacheLumpNum(int lump, int tag);
 void *W_CacheLumpName(char *name, int tag);
 
+int W_GetNumForLumpRef(lumpref_t *ref);
+void *W_CacheLumpRef(lumpref_t *ref, int tag);
+void W_ResolveLumpRefs(void);
+
 void W_GenerateHashTable(void);
 
 extern unsigned int W_LumpNameHash(const char *s);
+uint64_t W_LumpNameKey(const char *s);
 
 void W_ReleaseLumpNum(int lump);
 void W_ReleaseLumpName(char *name);
 
+void W_PrefetchLumpNum(int lump);
+void W_DiscardLumpNum(int lump);
+
 int IWADRequiredByPWAD(const char *pwadname);
 dboolean IsFreedoom(const char *iwadname);
 dboolean HasDehackedLump(const char *pwadname);
@@ -39,6 +39,8 @@
 #include "i_system.h"
 #include "z_zone.h"
 
+#include "SDL.h"
+
 // Minimum chunk size at which blocks are allocated
 #define CHUNK_SIZE      32
 
@@ -49,15 +51,125 @@ typedef struct memblock
     size_t              size;
     void                **user;
     unsigned char       tag;
+    dboolean            inarena;
 } memblock_t;
 
+// Blocks without a user that last until the level ends are carved out of large chunks
+// belonging to their tag, rather than being allocated one at a time. Freed blocks are
+// kept in a list for their size, to be reused by the next block of that size, and all
+// of the chunks are freed at once when the level ends.
+#define ARENA_CHUNK_SIZE        (256 * 1024)
+#define ARENA_MAX_SIZE          (ARENA_CHUNK_SIZE / 4)
+
+typedef struct arenachunk_s
+{
+    struct arenachunk_s *next;
+    size_t              used;
+} arenachunk_t;
+
+typedef struct
+{
+    arenachunk_t        *chunks;
+    memblock_t          *freeblocks[ARENA_MAX_SIZE / CHUNK_SIZE + 1];
+} arena_t;
+
 // size of block header
 // cph - base on sizeof(memblock_t), which can be larger than CHUNK_SIZE on
 // 64bit architectures
 static const size_t     HEADER_SIZE = (sizeof(memblock_t) + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
 
+static const size_t     ARENA_HEADER_SIZE = (sizeof(arenachunk_t) + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+
 static memblock_t       *blockbytag[PU_MAX];
 
+static arena_t          arenas[PU_MAX];
+
+#define ARENA_TAG(tag)  ((tag) == PU_LEVEL || (tag) == PU_LEVSPEC)
+
+// Serializes access to the zone memory from the threads rendering the view and
+// precaching textures. It is recursive, so can be held across several calls.
+static SDL_mutex        *zonelock;
+
+// The number of bytes allocated by Z_Malloc() since startup
+uint64_t                zonebytes;
+
+//
+// Z_Init
+//
+void Z_Init(void)
+{
+    if (!(zonelock = SDL_CreateMutex()))
+        I_Error("Z_Init: %s", SDL_GetError());
+}
+
+void Z_Lock(void)
+{
+    SDL_LockMutex(zonelock);
+}
+
+void Z_Unlock(void)
+{
+    SDL_UnlockMutex(zonelock);
+}
+
+//
+// Z_ArenaMalloc
+// Allocates a block of the given size, already rounded to
+//  the chunk size, from the arena of the given tag.
+//
+static memblock_t *Z_ArenaMalloc(size_t size, int tag)
+{
+    arena_t         *arena = &arenas[tag];
+    memblock_t      *block = arena->freeblocks[size / CHUNK_SIZE];
+    arenachunk_t    *chunk = arena->chunks;
+
+    // reuse a freed block of the same size
+    if (block)
+    {
+        arena->freeblocks[size / CHUNK_SIZE] = block->next;
+        return block;
+    }
+
+    if (!chunk || chunk->used + size + HEADER_SIZE > ARENA_CHUNK_SIZE)
+    {
+        while (!(chunk = malloc(ARENA_CHUNK_SIZE)))
+        {
+            if (!blockbytag[PU_CACHE])
+                I_Error("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long)size);
+            Z_FreeTags(PU_CACHE, PU_CACHE);
+        }
+
+        chunk->next = arena->chunks;
+        chunk->used = ARENA_HEADER_SIZE;
+        arena->chunks = chunk;
+    }
+
+    block = (memblock_t *)((char *)chunk + chunk->used);
+    chunk->used += size + HEADER_SIZE;
+
+    return block;
+}
+
+//
+// Z_FreeArena
+// Frees all of the chunks in the arena of the given tag at once.
+//
+static void Z_FreeArena(int tag)
+{
+    arena_t         *arena = &arenas[tag];
+    arenachunk_t    *chunk = arena->chunks;
+
+    while (chunk)
+    {
+        arenachunk_t    *next = chunk->next;
+
+        free(chunk);
+        chunk = next;
+    }
+
+    memset(arena, 0, sizeof(*arena));
+}
+
 //
 // Z_Malloc
 // You can pass a NULL user if the tag is < PU_PURGELEVEL.
@@ -79,6 +191,22 @@ void *Z_Malloc(size_t size, int tag, void **user)
 
     size = (size + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1); // round to chunk size
 
+    Z_Lock();
+
+    zonebytes += size;
+
+    if (ARENA_TAG(tag) && !user && size <= ARENA_MAX_SIZE)
+    {
+        block = Z_ArenaMalloc(size, tag);
+        block->next = block->prev = NULL;
+        block->size = size;
+        block->tag = tag;
+        block->user = NULL;
+        block->inarena = true;
+        Z_Unlock();
+        return ((char *)block + HEADER_SIZE);
+    }
+
     while (!(block = malloc(size + HEADER_SIZE)))
     {
         if (!blockbytag[PU_CACHE])
@@ -103,10 +231,12 @@ void *Z_Malloc(size_t size, int tag, void **user)
 
     block->tag = tag;                                   // tag
     block->user = user;                                 // user
+    block->inarena = false;
     block = (memblock_t *)((char *)block + HEADER_SIZE);
     if (user)                                           // if there is a user
         *user = block;                                  // set user to point to new block
 
+    Z_Unlock();
     return block;
 }
 
@@ -117,8 +247,21 @@ void Z_Free(void *p)
     if (!p)
         return;
 
+    Z_Lock();
+
+    if (block->inarena)
+    {
+        arena_t *arena = &arenas[block->tag];
+
+        // keep the block to reuse for the next of the same size
+        block->next = arena->freeblocks[block->size / CHUNK_SIZE];
+        arena->freeblocks[block->size / CHUNK_SIZE] = block;
+        Z_Unlock();
+        return;
+    }
+
     if (block->user)                                    // Nullify user if one exists
-        *block->user = NULL;
+        SDL_AtomicSetPtr(block->user, NULL);
 
     if (block == block->next)
         blockbytag[block->tag] = NULL;
@@ -128,6 +271,7 @@ void Z_Free(void *p)
     block->next->prev = block->prev;
 
     free(block);
+    Z_Unlock();
 }
 
 void Z_FreeTags(int32_t lowtag, int32_t hightag)
@@ -137,11 +281,16 @@ void Z_FreeTags(int32_t lowtag, int32_t hightag)
     if (hightag > PU_CACHE)
         hightag = PU_CACHE;
 
+    Z_Lock();
+
     for (; lowtag <= hightag; ++lowtag)
     {
         memblock_t      *block;
         memblock_t      *end_block;
 
+        if (ARENA_TAG(lowtag))
+            Z_FreeArena(lowtag);
+
         block = blockbytag[lowtag];
         if (!block)
             continue;
@@ -156,6 +305,8 @@ void Z_FreeTags(int32_t lowtag, int32_t hightag)
             block = next;                               // Advance to next block
         }
     }
+
+    Z_Unlock();
 }
 
 void Z_ChangeTag(void *ptr, int32_t tag)
@@ -166,9 +317,18 @@ void Z_ChangeTag(void *ptr, int32_t tag)
     if (!ptr)
         return;
 
+    Z_Lock();
+
     // proff - do nothing if tag doesn't differ
     if (tag == block->tag)
+    {
+        Z_Unlock();
         return;
+    }
+
+    // the block's memory belongs to its tag's arena
+    if (block->inarena)
+        I_Error("Z_ChangeTag: Can't change the tag of a block allocated from an arena");
 
     if (block == block->next)
         blockbytag[block->tag] = NULL;
@@ -191,14 +351,19 @@ void Z_ChangeTag(void *ptr, int32_t tag)
     }
 
     block->tag = tag;
+    Z_Unlock();
 }
 
 void Z_ChangeUser(void *ptr, void **user)
 {
     memblock_t  *block;
 
-    block = (memblock_t *)((byte *)ptr - sizeof(memblock_t));
+    block = (memblock_t *)((byte *)ptr - HEADER_SIZE);
 
+    Z_Lock();
     block->user = user;
-    *user = ptr;
+
+    // the block is published here, and may be read without the lock
+    SDL_AtomicSetPtr(user, ptr);
+    Z_Unlock();
 }
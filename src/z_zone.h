@@ -65,10 +65,15 @@ enum
 
 #define PU_PURGELEVEL    PU_CACHE    // First purgable tag's level
 
+void Z_Init(void);
+void Z_Lock(void);
+void Z_Unlock(void);
 void *Z_Malloc(size_t size, int32_t tag, void **user);
 void Z_Free(void *ptr);
 void Z_FreeTags(int32_t lowtag, int32_t hightag);
 void Z_ChangeTag(void *ptr, int32_t tag);
 void Z_ChangeUser(void *ptr, void **user);
 
+extern uint64_t zonebytes;
+
 #endif